@@ -0,0 +1,349 @@
+/*
+ * Newhaven Display Slim OLED Driver
+ * ---------------------------------
+ * 
+ * Tiled Virtual Canvas
+ * --------------------
+ * 
+ * NHD_OLED_Canvas joins several identical panels into one logical grid -
+ * for example, four 20x4 modules two across and two down make a 40x8
+ * canvas. Coordinates given to cursorPos() and print() are canvas
+ * coordinates; the canvas works out which panel each character lands on
+ * and where, so text running across a panel boundary is split
+ * automatically.
+ * 
+ * Each panel is an NHD_OLED_Frame, so writes only change the frames'
+ * buffers. flush() sends the changes panel by panel, starting one panel
+ * further along each time so no panel is always served last.
+ * 
+ * 
+ * Software License Agreement (BSD License)
+ * 
+ * Copyright (c) 2015-2017 by Newhaven Display International, Inc.
+ * Copyright (c) 2017-2018 by Tom Honaker.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF 
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+
+
+#include "Arduino.h"
+#include "NHD_OLED_Canvas.h"
+
+
+
+// NHD_OLED_Canvas::begin
+//
+// Joins a set of panels into one canvas. Every panel must have the same
+// geometry, and each frame must already have been attached to its display
+// with NHD_OLED_Frame::begin().
+//
+// Parameters:
+//   panels: array of across * down frames, in rows from the top-left panel
+//           - for two across and two down: top-left, top-right, bottom-
+//           left, bottom-right.
+//   across: number of panels side by side.
+//   down: number of panels stacked top to bottom.
+//
+void NHD_OLED_Canvas::begin(NHD_OLED_Frame *panels, byte across, byte down) {
+  this->panels = panels;
+  this->across = across;
+  this->down = down;
+
+  if ((across == 0) or (down == 0)) {
+    this->across = 0;
+    this->down = 0;
+    DISP_ROWS = 0;
+    DISP_COLUMNS = 0;
+  }
+  else {
+    DISP_ROWS = panels[0].DISP_ROWS * down;
+    DISP_COLUMNS = panels[0].DISP_COLUMNS * across;
+  }
+
+  cursorRow = 0;
+  cursorColumn = 0;
+  nextPanel = 0;
+}
+
+
+// NHD_OLED_Canvas::textClear
+//
+// Blanks every panel. Nothing is sent until flush().
+//
+void NHD_OLED_Canvas::textClear() {
+  for (byte i = 0; i < across * down; i++)
+    panels[i].textClear();
+
+  cursorRow = 0;
+  cursorColumn = 0;
+}
+
+
+// NHD_OLED_Canvas::textClearRow
+//
+// Blanks one canvas row/line, across every panel it runs through. Nothing
+// is sent until flush().
+//
+// Parameters:
+//   rowNumber: row/line number to clear (zero-indexed, where 0 is topmost).
+//
+void NHD_OLED_Canvas::textClearRow(byte rowNumber) {
+  byte panelRows, first;
+
+  if (rowNumber >= DISP_ROWS)
+    return;
+
+  panelRows = panels[0].DISP_ROWS;
+  first = (rowNumber / panelRows) * across;
+  for (byte i = 0; i < across; i++)
+    panels[first + i].textClearRow(rowNumber % panelRows);
+}
+
+
+// NHD_OLED_Canvas::cursorPos
+//
+// Moves the canvas write position.
+//
+// Parameters:
+//   row: canvas row/line number.
+//   column: canvas column number.
+//
+void NHD_OLED_Canvas::cursorPos(byte row, byte column) {
+  cursorRow = row;
+  cursorColumn = column;
+}
+
+
+// NHD_OLED_Canvas::print
+//
+// Writes text at the canvas write position, which moves along with the
+// text. Text crossing into the next panel across carries on there; text
+// running past the right edge of the canvas is dropped.
+//
+// Parameters:
+//   text: text to display. This should be a full string if a length is
+//         provided.
+//   len: length of text to print, in characters.
+//
+void NHD_OLED_Canvas::print(char *text, byte len) {
+  for (byte i = 0; i < len; i++)
+    print(text[i]);
+}
+
+
+// NHD_OLED_Canvas::print - OVERLOAD
+//
+// Writes a single character at the canvas write position.
+//
+// Parameters:
+//   text: text to display. This must be a single character.
+//
+void NHD_OLED_Canvas::print(char text) {
+  byte panelRows, panelColumns, panel;
+
+  if ((cursorRow < DISP_ROWS) and (cursorColumn < DISP_COLUMNS)) {
+    panelRows = panels[0].DISP_ROWS;
+    panelColumns = panels[0].DISP_COLUMNS;
+    panel = (cursorRow / panelRows) * across + (cursorColumn / panelColumns);
+    panels[panel].print(text, cursorRow % panelRows,
+                        cursorColumn % panelColumns);
+  }
+
+  if (cursorColumn < 255)
+    cursorColumn++;
+}
+
+
+// NHD_OLED_Canvas::print - OVERLOAD
+//
+// Moves the canvas write position, then writes text.
+//
+// Parameters:
+//   text: text to display. This should be a full string.
+//   len: length of text to print, in characters.
+//   r: canvas row/line number.
+//   c: canvas column number.
+//
+void NHD_OLED_Canvas::print(char *text, byte len, byte r, byte c) {
+  cursorPos(r, c);
+  print(text, len);
+}
+
+
+// NHD_OLED_Canvas::print - OVERLOAD
+//
+// Moves the canvas write position, then writes a single character.
+//
+// Parameters:
+//   text: text to display. This must be a single character.
+//   r: canvas row/line number.
+//   c: canvas column number.
+//
+void NHD_OLED_Canvas::print(char text, byte r, byte c) {
+  cursorPos(r, c);
+  print(text);
+}
+
+
+// NHD_OLED_Canvas::flush
+//
+// Sends the changes on every panel, each using its own cheapest plan. The
+// panel that goes first moves along by one on each call.
+//
+void NHD_OLED_Canvas::flush() {
+  byte count = across * down;
+
+  if (count == 0)
+    return;
+
+  for (byte i = 0; i < count; i++)
+    panels[(nextPanel + i) % count].flush();
+
+  nextPanel = (nextPanel + 1) % count;
+}
+
+
+// NHD_OLED_Canvas::flush - OVERLOAD
+//
+// Sends as much of the pending update as fits in a time budget, then
+// returns. If every panel's cheapest plan is estimated to fit, they're all
+// used as-is, as with flush(). Otherwise runs of changed cells are sent in
+// priority order across the whole canvas - highest priority first, then
+// top to bottom and left to right - so a high-priority row on one panel
+// goes ahead of a low-priority row on any other.
+//
+// Parameters:
+//   maxMicros: time budget, in microseconds.
+//
+// Returns the number of cells still waiting to be sent, across all panels.
+//
+unsigned int NHD_OLED_Canvas::flush(unsigned long maxMicros) {
+  unsigned long started = micros(), elapsed, costNs = 0, spentNs;
+  byte count = across * down, panelRows, i, r, a, panel, full = 0;
+  byte noCosts = 0;
+  int level = 256, next;
+
+  if (count == 0)
+    return 0;
+
+  for (i = 0; i < count; i++) {
+    panels[i].plan(panels[i].lastPlan);
+    costNs += panels[i].planNs();
+    if ((panels[i].lastPlan.kind != NHD_OLED_PLAN_NONE) and
+        (panels[i].oled->costDataNs == 0))
+      noCosts = 1;
+  }
+
+  elapsed = micros() - started;
+  if (noCosts or (costNs / 1000 + elapsed < maxMicros)) {
+    for (i = 0; i < count; i++)
+      panels[(nextPanel + i) % count].send();
+
+    nextPanel = (nextPanel + 1) % count;
+    return 0;
+  }
+
+  spentNs = NHD_OLED_Frame::budgetStart(maxMicros, elapsed);
+
+  for (i = 0; i < count; i++) {
+    panels[i].lastPlan.kind = NHD_OLED_PLAN_CELLS;
+    panels[i].lastPlan.commands = 0;
+    panels[i].lastPlan.data = 0;
+    panels[i].oled->batchBegin();
+  }
+
+  // One priority level at a time, highest first.
+  panelRows = panels[0].DISP_ROWS;
+  while (!full) {
+    next = -1;
+    for (i = 0; i < count; i++)
+      for (r = 0; r < panelRows; r++)
+        if ((panels[i].rowPriority[r] < level) and
+            (panels[i].rowPriority[r] > next))
+          next = panels[i].rowPriority[r];
+    if (next < 0)
+      break;
+    level = next;
+
+    for (r = 0; (r < DISP_ROWS) and !full; r++) {
+      for (a = 0; (a < across) and !full; a++) {
+        panel = (r / panelRows) * across + a;
+        if (panels[panel].rowPriority[r % panelRows] == level)
+          full = panels[panel].rowSend(r % panelRows, started, maxMicros,
+                                       spentNs);
+      }
+    }
+  }
+
+  for (i = 0; i < count; i++)
+    panels[i].oled->batchEnd();
+
+  return pending();
+}
+
+
+// NHD_OLED_Canvas::pending
+//
+// Returns the number of cells, across all panels, that differ from what the
+// displays show.
+//
+unsigned int NHD_OLED_Canvas::pending() {
+  unsigned int count = 0;
+
+  for (byte i = 0; i < across * down; i++)
+    count += panels[i].pending();
+
+  return count;
+}
+
+
+// NHD_OLED_Canvas::setRowPriority
+//
+// Sets the order rows are sent in when flush() is given a time budget. The
+// priority applies to the row on every panel it runs through.
+//
+// Parameters:
+//   row: canvas row/line number.
+//   priority: 0-255, where 255 is sent first.
+//
+void NHD_OLED_Canvas::setRowPriority(byte row, byte priority) {
+  byte panelRows, first;
+
+  if (row >= DISP_ROWS)
+    return;
+
+  panelRows = panels[0].DISP_ROWS;
+  first = (row / panelRows) * across;
+  for (byte i = 0; i < across; i++)
+    panels[first + i].setRowPriority(row % panelRows, priority);
+}
+
+
+
+/*
+ * End of file!
+ */
\ No newline at end of file
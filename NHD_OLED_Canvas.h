@@ -0,0 +1,93 @@
+/*
+ * Newhaven Display Slim OLED Driver
+ * ---------------------------------
+ * 
+ * Tiled Virtual Canvas
+ * --------------------
+ * 
+ * NHD_OLED_Canvas joins several identical panels into one logical grid -
+ * for example, four 20x4 modules two across and two down make a 40x8
+ * canvas. Coordinates given to cursorPos() and print() are canvas
+ * coordinates; the canvas works out which panel each character lands on
+ * and where, so text running across a panel boundary is split
+ * automatically.
+ * 
+ * Each panel is an NHD_OLED_Frame, so writes only change the frames'
+ * buffers. flush() sends the changes panel by panel, starting one panel
+ * further along each time so no panel is always served last.
+ * 
+ * 
+ * Software License Agreement (BSD License)
+ * 
+ * Copyright (c) 2015-2017 by Newhaven Display International, Inc.
+ * Copyright (c) 2017-2018 by Tom Honaker.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF 
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+
+
+#ifndef NHD_OLED_CANVAS_H
+#define NHD_OLED_CANVAS_H
+
+#include "Arduino.h"
+#include "NHD_OLED_Frame.h"
+
+class NHD_OLED_Canvas
+{
+  public:
+    void begin(NHD_OLED_Frame *panels, byte across, byte down);
+    void textClear();
+    void textClearRow(byte rowNumber);
+    void cursorPos(byte row, byte column);
+    void print(char *text, byte len);
+    void print(char text);
+    void print(char *text, byte len, byte r, byte c);
+    void print(char text, byte r, byte c);
+    void flush();
+    unsigned int flush(unsigned long maxMicros);
+    unsigned int pending();
+    void setRowPriority(byte row, byte priority);
+
+    // Canvas Geometry
+    byte DISP_ROWS = 0;
+    byte DISP_COLUMNS = 0;
+  private:
+    NHD_OLED_Frame *panels = 0;
+    byte across = 0;
+    byte down = 0;
+    byte cursorRow = 0;
+    byte cursorColumn = 0;
+    byte nextPanel = 0;
+};
+
+#endif
+
+
+
+/*
+ * End of file!
+ */
\ No newline at end of file
@@ -91,13 +91,67 @@
 //void NHD_OLED::begin(byte pinSCLK, byte pinSDIN, byte pinC_S, byte rows = 2, 
 //                     byte columns = 16) {
 //    setupPins(pinSCLK, pinSDIN, pinC_S);
-void NHD_OLED::begin(byte pinSCLK, byte pinSDIN, byte rows = 2, 
-                     byte columns = 16) {
+void NHD_OLED::begin(byte pinSCLK, byte pinSDIN, byte rows, byte columns) {
     setupPins(pinSCLK, pinSDIN);
     setupDisplaySize(rows, columns);
+    setupCalibrate();
     setupInit();
 }
 
+
+// NHD_OLED::beginParallel
+//
+// Performs all required initialization steps for a display strapped for an
+// 8-bit parallel bus, in a single command. Tie the display's /CS low, and
+// R/W low (6800) or /RD high (8080).
+//
+// Parameters:
+//    bus: NHD_OLED_BUS_6800 or NHD_OLED_BUS_8080.
+//    pinD_C: pin to use for data/command select - connect to display's D/C.
+//    pinE_WR: pin to use for the write strobe - connect to display's E
+//             (6800) or /WR (8080) pin.
+//    pinDB: array of the eight pins connected to display's DB0-DB7, in
+//           order.
+//    rows: number of rows/lines on the display.
+//    columns: number of columns/characters per line on the display.
+//
+void NHD_OLED::beginParallel(byte bus, byte pinD_C, byte pinE_WR,
+                             const byte *pinDB, byte rows, byte columns) {
+    setupParallel(bus, pinD_C, pinE_WR, pinDB);
+    setupDisplaySize(rows, columns);
+    setupCalibrate();
+    setupInit();
+}
+
+
+// The hold loop itself - a volatile count-down the compiler can't drop. A
+// core can supply its own beforehand; the host tools' stand-in Arduino.h
+// charges the loop to the simulated clock instead.
+#ifndef NHD_OLED_BUS_HOLD
+#define NHD_OLED_BUS_HOLD(loops)          \
+  do {                                    \
+    volatile unsigned int n = (loops);    \
+    while (n != 0)                        \
+      n--;                                \
+  } while (0)
+#endif
+
+
+// busHold
+//
+// Busy-waits for the given number of hold-loop iterations. Used to stretch
+// SCLK high/low phases on boards fast enough to outrun the display. Callers
+// skip it when the count is zero, which is the usual case on slower boards,
+// so those pay only for the test.
+//
+// Parameters:
+//   loops: number of iterations to wait.
+//
+static inline void busHold(unsigned int loops) {
+  NHD_OLED_BUS_HOLD(loops);
+}
+
+
 // NHD_OLED::SPIBitBang
 //
 // This function performs a simple send-only SPI connection using any three 
@@ -132,7 +186,11 @@ void NHD_OLED::SPIBitBang(byte data, byte isCommand) {
     digitalWrite(SCLK, LOW);
     digitalWrite(SDIN, ((cb & 0x80) >> 7));
     cb = cb << 1;
+    if (holdLowLoops != 0)
+      busHold(holdLowLoops);
     digitalWrite(SCLK, HIGH);
+    if (holdHighLoops != 0)
+      busHold(holdHighLoops);
   }
 
   // Then send the lowest 4 bits of the data byte, in little-endian order...
@@ -141,7 +199,11 @@ void NHD_OLED::SPIBitBang(byte data, byte isCommand) {
     digitalWrite(SCLK, LOW);
     digitalWrite(SDIN, (data & 0x01));
     data = data >> 1;
+    if (holdLowLoops != 0)
+      busHold(holdLowLoops);
     digitalWrite(SCLK, HIGH);
+    if (holdHighLoops != 0)
+      busHold(holdHighLoops);
   }
 
   // Then send four zero bits...
@@ -149,7 +211,11 @@ void NHD_OLED::SPIBitBang(byte data, byte isCommand) {
   {
     digitalWrite(SCLK, LOW);
     digitalWrite(SDIN, LOW);
+    if (holdLowLoops != 0)
+      busHold(holdLowLoops);
     digitalWrite(SCLK, HIGH);
+    if (holdHighLoops != 0)
+      busHold(holdHighLoops);
   }
 
   // Then send the highest 4 bits of the data byte, in little-endian order...
@@ -158,7 +224,11 @@ void NHD_OLED::SPIBitBang(byte data, byte isCommand) {
     digitalWrite(SCLK, LOW);
     digitalWrite(SDIN, (data & 0x01));
     data = data >> 1;
+    if (holdLowLoops != 0)
+      busHold(holdLowLoops);
     digitalWrite(SCLK, HIGH);
+    if (holdHighLoops != 0)
+      busHold(holdHighLoops);
   }
 
   // And wrap up the send with four zero bits...
@@ -166,11 +236,143 @@ void NHD_OLED::SPIBitBang(byte data, byte isCommand) {
   {
     digitalWrite(SCLK, LOW);
     digitalWrite(SDIN, LOW);
+    if (holdLowLoops != 0)
+      busHold(holdLowLoops);
     digitalWrite(SCLK, HIGH);
+    if (holdHighLoops != 0)
+      busHold(holdHighLoops);
   }
 }
 
 
+// NHD_OLED::parallelWrite
+//
+// Sends a whole byte per strobe over an 8-bit 6800- or 8080-style parallel
+// bus. D/C and the data lines are set up first, then the strobe is pulsed:
+// E high-then-low for 6800, /WR low-then-high for 8080. The display latches
+// the byte on the trailing edge. Strobe phases are stretched the same way
+// SCLK is for SPI.
+//
+// On AVR boards with DB0-DB7 wired in order to one port, the byte goes out
+// with a single port write, and D/C and the strobe are driven through their
+// port registers too.
+//
+// Parameters:
+//   data: byte to send to display
+//   isCommand: command/data flag, where 0 = data and <>0 = command
+//
+void NHD_OLED::parallelWrite(byte data, byte isCommand) {
+  byte i;
+
+#if defined(__AVR__)
+  if (parFast) {
+    uint8_t oldSREG = SREG;
+
+    cli();
+    if (isCommand == 0)
+      *parD_CPort |= parD_CMask;
+    else
+      *parD_CPort &= ~parD_CMask;
+
+    *parDBPort = data;
+
+    if (busType == NHD_OLED_BUS_6800) {
+      *parE_WRPort |= parE_WRMask;
+      if (holdHighLoops != 0)
+        busHold(holdHighLoops);
+      *parE_WRPort &= ~parE_WRMask;
+      SREG = oldSREG;
+      if (holdLowLoops != 0)
+        busHold(holdLowLoops);
+    }
+    else {
+      *parE_WRPort &= ~parE_WRMask;
+      if (holdLowLoops != 0)
+        busHold(holdLowLoops);
+      *parE_WRPort |= parE_WRMask;
+      SREG = oldSREG;
+      if (holdHighLoops != 0)
+        busHold(holdHighLoops);
+    }
+    return;
+  }
+#endif
+
+  digitalWrite(D_C, (isCommand == 0));
+
+  for (i = 0; i < 8; i++)
+    digitalWrite(DB[i], ((data >> i) & 0x01));
+
+  if (busType == NHD_OLED_BUS_6800) {
+    digitalWrite(E_WR, HIGH);
+    if (holdHighLoops != 0)
+      busHold(holdHighLoops);
+    digitalWrite(E_WR, LOW);
+    if (holdLowLoops != 0)
+      busHold(holdLowLoops);
+  }
+  else {
+    digitalWrite(E_WR, LOW);
+    if (holdLowLoops != 0)
+      busHold(holdLowLoops);
+    digitalWrite(E_WR, HIGH);
+    if (holdHighLoops != 0)
+      busHold(holdHighLoops);
+  }
+}
+
+
+// NHD_OLED::busWrite
+//
+// Sends a byte over whichever interface the display is connected with.
+//
+// Parameters:
+//   data: byte to send to display
+//   isCommand: command/data flag, where 0 = data and <>0 = command
+//
+void NHD_OLED::busWrite(byte data, byte isCommand) {
+  switch (busType) {
+    case NHD_OLED_BUS_I2C:
+      (this->*i2cWrite)(data, isCommand);
+      break;
+    case NHD_OLED_BUS_6800:
+    case NHD_OLED_BUS_8080:
+      parallelWrite(data, isCommand);
+      break;
+    default:
+      SPIBitBang(data, isCommand);
+      break;
+  }
+}
+
+
+// NHD_OLED::batchBegin
+//
+// Starts a batch of commands and data that can be sent together. Over I2C,
+// bytes sent inside a batch are packed into as few transactions as Wire's
+// buffer allows; over SPI this makes no difference. Batches can be nested,
+// and nothing is guaranteed to reach the display until the outermost
+// batchEnd(), so don't put delays that the display relies on inside one.
+//
+void NHD_OLED::batchBegin() {
+  batchDepth++;
+}
+
+
+// NHD_OLED::batchEnd
+//
+// Ends a batch started with batchBegin(), sending anything still queued once
+// the outermost batch ends.
+//
+void NHD_OLED::batchEnd() {
+  if (batchDepth > 0)
+    batchDepth--;
+
+  if ((batchDepth == 0) and (busType == NHD_OLED_BUS_I2C))
+    (this->*i2cFlush)();
+}
+
+
 // NHD_OLED::sendCommand
 //
 // Provides an alternative means to send a command byte to the display.
@@ -179,7 +381,7 @@ void NHD_OLED::SPIBitBang(byte data, byte isCommand) {
 //   command: command byte to send.
 //
 void NHD_OLED::sendCommand(byte command) {
-  SPIBitBang(command, 1);
+  busWrite(command, 1);
 }
 
 
@@ -191,7 +393,66 @@ void NHD_OLED::sendCommand(byte command) {
 //   data: command byte to send.
 //
 void NHD_OLED::sendData(byte data) {
-  SPIBitBang(data, 0);
+  busWrite(data, 0);
+}
+
+
+// NHD_OLED::macroPlay
+//
+// Replays a pre-recorded stream of commands and data from program memory -
+// handy for static screens that are drawn the same way every time. The
+// stream is a series of opcodes, each followed by its bytes:
+//
+//   00nnnnnn: n data bytes follow (00000000 ends the stream)
+//   01nnnnnn: n command bytes follow
+//   10nnnnnn: one data byte follows, to be sent n times
+//   11nnnnnn: wait n milliseconds
+//
+// The whole stream is sent as one batch, straight to the bus, and no RAM
+// buffer is needed. The macro_record host tool in extras/host turns a run of
+// ordinary API calls into a stream.
+//
+// Parameters:
+//   macro: PROGMEM macro stream.
+//
+void NHD_OLED::macroPlay(const byte *macro) {
+  byte op, count, value;
+
+  batchBegin();
+
+  for (;;) {
+    op = pgm_read_byte(macro++);
+    count = op & 0x3F;
+
+    switch (op & 0xC0) {
+      case NHD_OLED_MACRO_DATA:
+        if (count == 0) {
+          batchEnd();
+          return;
+        }
+        while (count-- > 0)
+          busWrite(pgm_read_byte(macro++), 0);
+        break;
+
+      case NHD_OLED_MACRO_COMMANDS:
+        while (count-- > 0)
+          busWrite(pgm_read_byte(macro++), 1);
+        break;
+
+      case NHD_OLED_MACRO_REPEAT:
+        value = pgm_read_byte(macro++);
+        while (count-- > 0)
+          busWrite(value, 0);
+        break;
+
+      case NHD_OLED_MACRO_DELAY:
+        // Whatever came before the delay has to reach the display first.
+        if (busType == NHD_OLED_BUS_I2C)
+          (this->*i2cFlush)();
+        delay(count);
+        break;
+    }
+  }
 }
 
 
@@ -205,9 +466,14 @@ void NHD_OLED::sendData(byte data) {
 //    rows: number of rows/lines on the display.
 //    columns: number of columns/characters per line on the display.
 //
-void NHD_OLED::setupDisplaySize(byte rows = 2, byte columns = 16) {
+void NHD_OLED::setupDisplaySize(byte rows, byte columns) {
   DISP_ROWS = rows;
   DISP_COLUMNS = columns;
+
+  physicalRows = rows;
+  doubleHeight = NHD_OLED_DOUBLE_NONE;
+  for (byte i = 0; i < 4; i++)
+    rowMap[i] = i;
 }
 
 
@@ -236,18 +502,292 @@ void NHD_OLED::setupPins(byte pinSCLK, byte pinSDIN) {
 
   digitalWrite(SCLK, HIGH);
   digitalWrite(SDIN, HIGH);
+  busCostUpdate();
+
+  delay(30);
+}
+
+
+// NHD_OLED::setupParallel
+//
+// Switches the driver to the display's 8-bit parallel interface and
+// configures its pins. The display's BS pins must be strapped for the
+// matching bus; see its datasheet.
+//
+// Parameters:
+//    bus: NHD_OLED_BUS_6800 or NHD_OLED_BUS_8080.
+//    pinD_C: pin to use for data/command select - connect to display's D/C.
+//    pinE_WR: pin to use for the write strobe - connect to display's E
+//             (6800) or /WR (8080) pin.
+//    pinDB: array of the eight pins connected to display's DB0-DB7, in
+//           order.
+//
+void NHD_OLED::setupParallel(byte bus, byte pinD_C, byte pinE_WR,
+                             const byte *pinDB) {
+  byte i;
+
+  busType = bus;
+  D_C = pinD_C;
+  E_WR = pinE_WR;
+
+  pinMode(D_C, OUTPUT);
+  pinMode(E_WR, OUTPUT);
+  digitalWrite(D_C, HIGH);
+
+  // Park the strobe in its idle state.
+  if (busType == NHD_OLED_BUS_6800)
+    digitalWrite(E_WR, LOW);
+  else
+    digitalWrite(E_WR, HIGH);
+
+  for (i = 0; i < 8; i++) {
+    DB[i] = pinDB[i];
+    pinMode(DB[i], OUTPUT);
+    digitalWrite(DB[i], LOW);
+  }
+
+#if defined(__AVR__)
+  // Direct port writes are only possible if DB0-DB7 map to bits 0-7 of a
+  // single port.
+  parFast = 1;
+  for (i = 0; i < 8; i++)
+    if ((digitalPinToPort(DB[i]) != digitalPinToPort(DB[0])) or
+        (digitalPinToBitMask(DB[i]) != (1 << i)))
+      parFast = 0;
+
+  if (parFast) {
+    parDBPort = portOutputRegister(digitalPinToPort(DB[0]));
+    parD_CPort = portOutputRegister(digitalPinToPort(D_C));
+    parD_CMask = digitalPinToBitMask(D_C);
+    parE_WRPort = portOutputRegister(digitalPinToPort(E_WR));
+    parE_WRMask = digitalPinToBitMask(E_WR);
+  }
+#endif
+  busCostUpdate();
 
   delay(30);
 }
 
 
+// NHD_OLED::setupBusTiming
+//
+// Sets the minimum SCLK high and low times the display needs - or, on the
+// parallel bus, the minimum strobe high and low times. The driver only
+// stretches the clock by however much the measured pin-write cost falls
+// short of these, so call setupCalibrate() (or begin(), which does so) for
+// the settings to take effect. The defaults are conservative figures for the
+// US2066 controller - check the datasheet if your module uses another one.
+//
+// Parameters:
+//   minHighNs: minimum SCLK high time, in nanoseconds.
+//   minLowNs: minimum SCLK low time, in nanoseconds.
+//
+void NHD_OLED::setupBusTiming(unsigned int minHighNs, unsigned int minLowNs) {
+  busHighNs = minHighNs;
+  busLowNs = minLowNs;
+
+  busTimingUpdate();
+}
+
+
+// NHD_OLED::setupCalibrate
+//
+// Measures how long a pin write and a hold-loop iteration actually take on
+// this board, then works out how many hold loops each SCLK phase needs to
+// meet the setupBusTiming() minimums. On slow boards where a pin write alone
+// takes longer than the minimum, no delay is added at all.
+//
+// SDIN is toggled with SCLK parked high while measuring. The display only
+// samples SDIN on a rising SCLK edge, so this is invisible to it. On the
+// parallel bus, D/C is toggled the same way the strobe would be driven, with
+// the strobe idle. Call after setupPins() or setupParallel().
+//
+void NHD_OLED::setupCalibrate() {
+  unsigned long start, elapsed;
+  unsigned long count;
+  byte pin, i;
+
+  pin = SDIN;
+  if ((busType == NHD_OLED_BUS_6800) or (busType == NHD_OLED_BUS_8080))
+    pin = D_C;
+
+  // Time pin writes, in batches so the cost of micros() is spread thin.
+  count = 0;
+  start = micros();
+  do {
+#if defined(__AVR__)
+    if (parFast) {
+      for (i = 0; i < 32; i++) {
+        uint8_t oldSREG = SREG;
+        cli();
+        *parD_CPort &= ~parD_CMask;
+        SREG = oldSREG;
+        oldSREG = SREG;
+        cli();
+        *parD_CPort |= parD_CMask;
+        SREG = oldSREG;
+      }
+    }
+    else
+#endif
+    for (i = 0; i < 32; i++) {
+      digitalWrite(pin, LOW);
+      digitalWrite(pin, HIGH);
+    }
+    count += 64;
+    elapsed = micros() - start;
+  } while (elapsed < NHD_OLED_CALIBRATE_US);
+
+  // Rounding down here errs towards longer holds, never shorter ones.
+  pinWriteNs = (elapsed * 1000UL) / count;
+
+  // Time the hold loop.
+  count = 0;
+  start = micros();
+  do {
+    busHold(255);
+    count += 255;
+    elapsed = micros() - start;
+  } while (elapsed < NHD_OLED_CALIBRATE_US);
+
+  holdLoopNs = (elapsed * 1000UL) / count;
+  if (holdLoopNs == 0)
+    holdLoopNs = 1;
+
+  busTimingUpdate();
+}
+
+
+// NHD_OLED::busTimingUpdate
+//
+// Converts the SCLK minimums into hold-loop counts using the most recent
+// calibration. Each SCLK phase already spans one pin write (SDIN while low,
+// the next SCLK write while high), so only the shortfall is padded out.
+//
+void NHD_OLED::busTimingUpdate() {
+  holdHighLoops = holdLoopsFor(busHighNs);
+  holdLowLoops = holdLoopsFor(busLowNs);
+
+  busCostUpdate();
+}
+
+
+// NHD_OLED::busCostUpdate
+//
+// Estimates what a data byte and a lone command byte cost on the current
+// interface, for planners like NHD_OLED_Frame that weigh one way of updating
+// the display against another. SPI and parallel costs come from the latest
+// calibration, or from NHD_OLED_PIN_WRITE_NS if setupCalibrate() hasn't
+// run; I2C costs come from the bus speed, counting nine clocks per byte.
+// Over I2C a command ahead of a run of data costs a new transaction:
+// address, control byte, the command, and the run's own control byte.
+//
+void NHD_OLED::busCostUpdate() {
+  unsigned long holdNs = (unsigned long)(holdHighLoops + holdLowLoops) *
+                         holdLoopNs;
+  unsigned long writeNs = (pinWriteNs != 0) ? pinWriteNs
+                                            : NHD_OLED_PIN_WRITE_NS;
+  unsigned long byteNs;
+
+  switch (busType) {
+    case NHD_OLED_BUS_I2C:
+      byteNs = 9000000UL / ((i2cClock >= 1000) ? (i2cClock / 1000) : 1);
+      costDataNs = byteNs;
+      costCommandNs = 4 * byteNs;
+      break;
+    case NHD_OLED_BUS_6800:
+    case NHD_OLED_BUS_8080:
+      // D/C, the data lines and two strobe edges - or, with direct port
+      // access, about three writes' worth.
+      costDataNs = (parFast ? 3UL : 11UL) * writeNs + holdNs;
+      costCommandNs = costDataNs;
+      break;
+    default:
+      // Three pin writes per bit, 24 bits per frame.
+      costDataNs = 24UL * (3UL * writeNs + holdNs);
+      costCommandNs = costDataNs;
+      break;
+  }
+}
+
+
+// NHD_OLED::runEnd
+//
+// Finds where a run of characters needing writing ends. Runs separated by a
+// gap are merged when resending the gap's unchanged characters costs no more
+// than a set-address command for the next run.
+//
+// Parameters:
+//   before: characters currently shown.
+//   after: characters to show.
+//   start: first character of the run, which must differ.
+//   width: number of characters in before and after.
+//
+// Returns the index just past the end of the run.
+//
+byte NHD_OLED::runEnd(const char *before, const char *after, byte start,
+                      byte width) {
+  byte end = start + 1, gap;
+
+  while (end < width) {
+    if (before[end] != after[end]) {
+      end++;
+      continue;
+    }
+
+    gap = end;
+    while ((gap < width) and (before[gap] == after[gap]))
+      gap++;
+
+    if ((gap == width) or ((gap - end) * costDataNs > costCommandNs))
+      break;
+
+    end = gap;
+  }
+
+  return end;
+}
+
+
+// NHD_OLED::holdLoopsFor
+//
+// Works out how many hold loops pad a single pin write out to the given
+// minimum time.
+//
+// Parameters:
+//   minNs: minimum phase time, in nanoseconds.
+//
+// Returns the hold-loop count.
+//
+unsigned int NHD_OLED::holdLoopsFor(unsigned int minNs) {
+  // Not calibrated yet, or the pin write alone is slow enough.
+  if ((holdLoopNs == 0) or (minNs <= pinWriteNs))
+    return 0;
+
+  return ((minNs - pinWriteNs) + holdLoopNs - 1) / holdLoopNs;
+}
+
+
 // NHD_OLED::setupInit
 //
 // Initializes and configures the display. Note that the command set provided
 // below is for Newhaven's slim OLED line, and individual products may require
 // different settings.
 //
+// The row count comes from DISP_ROWS, so sketches that set it directly
+// rather than through setupDisplaySize() still work. In double-height mode
+// DISP_ROWS counts merged rows, so the display's own row count is kept.
+//
 void NHD_OLED::setupInit() {
+    // Make sure planners have cost estimates to work with, even if the
+    // transport was set up by hand.
+    busCostUpdate();
+
+    if (doubleHeight == NHD_OLED_DOUBLE_NONE)
+      physicalRows = DISP_ROWS;
+
+    batchBegin();
+
     // Internal voltage regulator configuration
     sendCommand(0x2A);     // Function set select > extended command set enable (RE = 1)
     sendCommand(0x71);     // Internal Vdd regualtor control (function selection A) - command
@@ -266,16 +806,16 @@ void NHD_OLED::setupInit() {
 
     // Row count configuration
     sendCommand(0x28);     // Function set select > fundamental (default) command set (RE = 0)
-    if (DISP_ROWS < 3){
+    if (physicalRows < 3){
       sendCommand(0x08);   // Set row/line count (extended function set) - 1-/2-lines
-      if (DISP_ROWS == 1)
+      if (physicalRows == 1)
         sendCommand(0x20); // Set row/line count (extended function set) - 1 line
       else
         sendCommand(0x28); // Set row/line count (extended function set) - 2 lines
     }
     else{
       sendCommand(0x09);   // Set row/line count (extended function set) - 3-/4-lines
-      if (DISP_ROWS == 3)
+      if (physicalRows == 3)
         sendCommand(0x20); // Set row/line count (extended function set) - 3 lines
       else
         sendCommand(0x28); // Set row/line count (extended function set) - 4 lines
@@ -311,6 +851,14 @@ void NHD_OLED::setupInit() {
     sendCommand(0x80);     // Set DDRAM address to 0x00 (home on topmost row/line)
     sendCommand(0x0C);     // Display ON
 
+    batchEnd();
+
+    // The function set above leaves double-height mode off.
+    DISP_ROWS = physicalRows;
+    doubleHeight = NHD_OLED_DOUBLE_NONE;
+    for (byte i = 0; i < 4; i++)
+      rowMap[i] = i;
+
     delay(100);
 }
 
@@ -362,13 +910,76 @@ void NHD_OLED::displayOff() {
 }
 
 
+// NHD_OLED::displayDoubleHeight
+//
+// Merges pairs of rows/lines into double-height rows/lines, or splits them
+// again. Afterwards, rows/lines are numbered as they appear - with the top
+// pair merged on a 4-line display, row 0 is the big one and rows 1 and 2
+// are the two normal ones below it - and DISP_ROWS counts them the same
+// way, so cursorPos(), the centering helpers and anything else working from
+// DISP_ROWS carry on working. A merged row/line shows the DDRAM row of its
+// upper half.
+//
+// The three commands involved - into the extended set (RE = 1), the
+// row-pair selection, and back out with the double-height bit - are sent as
+// one batch. The row-pair encodings follow the US2066 datasheet; they
+// haven't been checked against every Newhaven module.
+//
+// Parameters:
+//   mode: one of the NHD_OLED_DOUBLE_ values. 2-line displays support only
+//         NHD_OLED_DOUBLE_TOP (one big row/line) and NHD_OLED_DOUBLE_NONE,
+//         and 1- and 3-line displays only NHD_OLED_DOUBLE_NONE. Anything
+//         else is ignored.
+//
+void NHD_OLED::displayDoubleHeight(byte mode) {
+  // UD2/UD1 row-pair bits, and the rows left visible, per mode. From the
+  // US2066 datasheet's Double Height command table (RE = 1, IS = 0): 00
+  // merges lines 1-2, 01 lines 2-3, 10 lines 1-2 and 3-4, and 11 lines 3-4.
+  static const byte pairBits[5] = {0x00, 0x00, 0x04, 0x0C, 0x08};
+  static const byte rowMaps[5][4] = {
+    {0, 1, 2, 3}, {0, 2, 3, 3}, {0, 1, 3, 3}, {0, 1, 2, 2}, {0, 2, 2, 2}
+  };
+  static const byte rowCounts[5] = {4, 3, 3, 3, 2};
+  byte functionSet = (physicalRows == 2 or physicalRows == 4) ? 0x28 : 0x20;
+
+  if (mode > NHD_OLED_DOUBLE_BOTH)
+    return;
+  if ((mode != NHD_OLED_DOUBLE_NONE) and (physicalRows != 4) and
+      !((physicalRows == 2) and (mode == NHD_OLED_DOUBLE_TOP)))
+    return;
+
+  batchBegin();
+
+  if (mode != NHD_OLED_DOUBLE_NONE) {
+    sendCommand(functionSet | 0x02);       // Function set > extended command set enable (RE = 1)
+    sendCommand(0x10 | pairBits[mode]);    // Double height > row pair (UD2/UD1)
+    sendCommand(functionSet | 0x04);       // Function set > RE = 0, double height on (DH = 1)
+  }
+  else {
+    sendCommand(functionSet);              // Function set > RE = 0, double height off (DH = 0)
+  }
+
+  batchEnd();
+
+  doubleHeight = mode;
+  for (byte i = 0; i < 4; i++)
+    rowMap[i] = rowMaps[mode][i];
+
+  DISP_ROWS = physicalRows;
+  if (physicalRows == 4)
+    DISP_ROWS = rowCounts[mode];
+  else if (mode == NHD_OLED_DOUBLE_TOP)
+    DISP_ROWS = 1;
+}
+
+
 // NHD_OLED::textClear
 //
 // Sends a "clear" command to the display.
 //
 void NHD_OLED::textClear() {
   sendCommand(0x01);
-  delay(10);
+  delay(NHD_OLED_CLEAR_MS);
 }
 
 
@@ -379,7 +990,7 @@ void NHD_OLED::textClear() {
 //
 void NHD_OLED::cursorHome() {
   sendCommand(0x02);
-  delay(10);
+  delay(NHD_OLED_CLEAR_MS);
 }
 
 
@@ -393,7 +1004,10 @@ void NHD_OLED::cursorHome() {
 void NHD_OLED::cursorMoveToRow(byte rowNumber) {
   byte row_command[4] = {0x80, 0xA0, 0xC0, 0xE0};
 
-  sendCommand(row_command[rowNumber]);
+  if (rowNumber >= DISP_ROWS)
+    rowNumber = DISP_ROWS - 1;
+
+  sendCommand(row_command[rowMap[rowNumber]]);
   delay(10);
 }
 
@@ -406,13 +1020,12 @@ void NHD_OLED::cursorMoveToRow(byte rowNumber) {
 //   rowNumber: row/line number to clear (zero-indexed, where 0 is topmost).
 //
 void NHD_OLED::textClearRow(byte rowNumber) {
-  char temp[DISP_COLUMNS];
+  batchBegin();
 
-  for (int i; i < DISP_COLUMNS; i++)
-    temp[i] = 0x20;
+  cursorPos(rowNumber, 0);
+  fillRun(0x20, DISP_COLUMNS);
 
-  cursorMoveToRow(rowNumber);
-  print(temp, DISP_COLUMNS);
+  batchEnd();
 }
 
 
@@ -453,7 +1066,7 @@ void NHD_OLED::cursorPos(byte row, byte column) {
   if (column >= DISP_COLUMNS)
     column = DISP_COLUMNS - 1;
 
-  sendCommand(row_command[row] + column);
+  sendCommand(row_command[rowMap[row]] + column);
 }
 
 
@@ -469,8 +1082,12 @@ void NHD_OLED::cursorPos(byte row, byte column) {
 //   len: length of text to print, in characters.
 //
 void NHD_OLED::print(char *text, byte len) {
+  batchBegin();
+
   for (byte i = 0; i < len; i++)
     sendData(text[i]);  
+
+  batchEnd();
 }
 
 
@@ -513,10 +1130,14 @@ void NHD_OLED::print(char text) {
 // before printing text may be deisrable.
 //
 void NHD_OLED::print(char *text, byte len, byte r, byte c) {
+  batchBegin();
+
   cursorPos(r, c);
 
   for (byte i = 0; i < len; i++)
     sendData(text[i]);
+
+  batchEnd();
 }
 
 
@@ -533,16 +1154,40 @@ void NHD_OLED::print(char *text, byte len, byte r, byte c) {
 //   c: column number (0-16/20).
 //
 void NHD_OLED::print(char text, byte r, byte c) {
+  batchBegin();
+
   cursorPos(r, c);
 
   sendData(text);
+
+  batchEnd();
+}
+
+
+// NHD_OLED::fillRun
+//
+// Prints the same character a number of times from the current cursor
+// position, without needing a buffer to hold them.
+//
+// Parameters:
+//   ch: character to repeat.
+//   count: number of times to print it.
+//
+void NHD_OLED::fillRun(char ch, byte count) {
+  batchBegin();
+
+  for (byte i = 0; i < count; i++)
+    sendData(ch);
+
+  batchEnd();
 }
 
 
 // NHD_OLED::textPrintCentered
 //
-// Prints the supplied text, centered, on the selected row/line. The row/line
-// is cleared before printing.
+// Prints the supplied text, centered, on the selected row/line. The rest of
+// the row/line is filled with spaces in the same pass, so the whole row is
+// only sent once. Text longer than the row is cut short.
 //
 // Parameters:
 //   text: text to display. This should be a full string.
@@ -550,32 +1195,28 @@ void NHD_OLED::print(char text, byte r, byte c) {
 //   row: row/line number (0-1/2/3).
 //
 void NHD_OLED::textPrintCentered(char *text, byte length, byte row) {
-  byte i;
-  char line[DISP_COLUMNS];
+  byte pad;
 
-  // Clear the text buffer.
-  for (i = 0; i < DISP_COLUMNS; i++)
-    line[i] = 0x20;
-
-  // Copy text into buffer, centering it relative to the line's width.
-  for (i = 0; i < length; i++)
-    line[((DISP_COLUMNS - length) / 2) + i] = text[i]; 
+  if (length > DISP_COLUMNS)
+    length = DISP_COLUMNS;
+  pad = (DISP_COLUMNS - length) / 2;
 
-  // Clear the line.
-  textClearRow(row);
+  batchBegin();
 
-  // Move the cursor to the row/line.
-  cursorMoveToRow(row);
+  cursorPos(row, 0);
+  fillRun(0x20, pad);
+  print(text, length);
+  fillRun(0x20, DISP_COLUMNS - length - pad);
 
-  // Print the centered text.
-  print(line, DISP_COLUMNS);
+  batchEnd();
 }
 
 
 // NHD_OLED::textPrintRightJustified
 //
 // Prints the supplied text, right-justified, on the selected row/line. The
-// row/line is cleared before printing.
+// start of the row/line is filled with spaces in the same pass, so the whole
+// row is only sent once. Text longer than the row is cut short.
 //
 // Parameters:
 //   text: text to display. This should be a full string.
@@ -583,25 +1224,16 @@ void NHD_OLED::textPrintCentered(char *text, byte length, byte row) {
 //   row: row/line number (0-1/2/3).
 //
 void NHD_OLED::textPrintRightJustified(char *text, byte length, byte row) {
-  byte i;
-  char line[DISP_COLUMNS];
+  if (length > DISP_COLUMNS)
+    length = DISP_COLUMNS;
 
-  // Clear the text buffer.
-  for (i = 0; i < DISP_COLUMNS; i++)
-    line[i] = 0x20;
+  batchBegin();
 
-  // Copy text into buffer, centering it relative to the line's width.
-  for (i = 0; i < length; i++)
-    line[(DISP_COLUMNS - length) + i] = text[i]; 
-
-  // Clear the row/line.
-  textClearRow(row);
+  cursorPos(row, 0);
+  fillRun(0x20, DISP_COLUMNS - length);
+  print(text, length);
 
-  // Move the cursor to the row/line.
-  cursorMoveToRow(row);
-
-  // Print the centered text.
-  print(line, DISP_COLUMNS);
+  batchEnd();
 }
 
 
@@ -705,6 +1337,7 @@ void NHD_OLED::textSweep(char *text, byte length, byte row, char leftSweepChar,
   // The first half of the process: sweep into the center.
   for (i = 0; i < (DISP_COLUMNS / 2); i++){
     cursorMoveToRow(row);
+    batchBegin();
 
     // Work out some starting positions and widths.
     outer = stepnum;
@@ -712,23 +1345,21 @@ void NHD_OLED::textSweep(char *text, byte length, byte row, char leftSweepChar,
     start = stepnum + 2;
     
     // Print leading spaces to pad the start of the line...
-    for (ii = 0; ii < outer; ii++)
-      print(0x20);
+    fillRun(0x20, outer);
 
     // ... then print the left-to-right character...
     print(leftSweepChar);
 
     // ... followed by spaces in the middle...
-    for (ii = 0; ii < inner; ii++)
-      print(0x20);
+    fillRun(0x20, inner);
 
     // ... then the right-to-left character...
     print(rightSweepChar);    
 
     // ... and finish with more spaces to clear the rest of the line.
-    for (ii = 0; ii < outer; ii++)
-      print(0x20);
+    fillRun(0x20, outer);
 
+    batchEnd();
     delay(timeDelay);
     
     stepnum++;
@@ -742,6 +1373,7 @@ void NHD_OLED::textSweep(char *text, byte length, byte row, char leftSweepChar,
   // The second half: sweep out from the center, leaving text behind.
   for (i = (DISP_COLUMNS / 2); i < DISP_COLUMNS; i++){
     cursorMoveToRow(row);
+    batchBegin();
 
     // More starts and widths.
     outer = stepnum;
@@ -749,8 +1381,7 @@ void NHD_OLED::textSweep(char *text, byte length, byte row, char leftSweepChar,
     start = stepnum + 1;
 
     // This pass is similar to the first, starting with padding...
-    for (ii = 0; ii < outer; ii++)
-      print(0x20);
+    fillRun(0x20, outer);
 
     // ... then the right-to-left character, as though it passed through its
     // opposite...
@@ -764,9 +1395,9 @@ void NHD_OLED::textSweep(char *text, byte length, byte row, char leftSweepChar,
     print(leftSweepChar);    
 
     // ... then spaces to clear the line.
-    for (ii = 0; ii < outer; ii++)
-      print(0x20);
+    fillRun(0x20, outer);
 
+    batchEnd();
     delay(timeDelay);
     
     stepnum--;
@@ -846,7 +1477,33 @@ void NHD_OLED::rightToLeft() {
 }
 
 void NHD_OLED::createChar(byte num, char* data) {
-  // This LiquidCrystal function is not supported in this library.
+  cgramWrite(num, (const byte *)data);
+}
+
+
+// NHD_OLED::cgramWrite
+//
+// Writes an 8-row bitmap into one of the display's CGRAM slots. Every cell
+// showing character code slot (0-7) picks up the new bitmap. This leaves the
+// address counter in CGRAM, so move the cursor before printing again.
+//
+// Parameters:
+//   slot: CGRAM slot/character code, 0-7.
+//   bitmap: 8 bytes, one per row, using the low 5 bits.
+//   fromProgmem: non-zero if bitmap is in program memory.
+//
+void NHD_OLED::cgramWrite(byte slot, const byte *bitmap, byte fromProgmem) {
+  byte row;
+
+  batchBegin();
+
+  sendCommand(0x40 | ((slot & 0x07) << 3));  // Set CGRAM address
+  for (byte i = 0; i < 8; i++) {
+    row = fromProgmem ? pgm_read_byte(bitmap + i) : bitmap[i];
+    sendData(row & 0x1F);
+  }
+
+  batchEnd();
 }
 
 
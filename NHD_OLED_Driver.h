@@ -75,6 +75,53 @@
 
 #include "Arduino.h"
 
+// Cores without a pointer-sized PROGMEM read have 16-bit pointers.
+#ifndef pgm_read_ptr
+#define pgm_read_ptr(addr) ((void *)pgm_read_word(addr))
+#endif
+
+// Interfaces the display can be connected with.
+#define NHD_OLED_BUS_SPI 0
+#define NHD_OLED_BUS_I2C 1
+#define NHD_OLED_BUS_6800 2
+#define NHD_OLED_BUS_8080 3
+
+// Default I2C address (SA0 tied low) and bus speed.
+#define NHD_OLED_I2C_ADDRESS 0x3C
+#define NHD_OLED_I2C_CLOCK   100000
+
+// Double-height modes - which pairs of rows/lines are merged.
+#define NHD_OLED_DOUBLE_NONE   0  // Every row/line normal height
+#define NHD_OLED_DOUBLE_TOP    1  // Rows 0-1 merged
+#define NHD_OLED_DOUBLE_MIDDLE 2  // Rows 1-2 merged (4-line displays)
+#define NHD_OLED_DOUBLE_BOTTOM 3  // Rows 2-3 merged (4-line displays)
+#define NHD_OLED_DOUBLE_BOTH   4  // Rows 0-1 and 2-3 merged (4-line displays)
+
+// Macro stream opcodes - the top two bits of each opcode byte; the low six
+// bits hold a count (1-63).
+#define NHD_OLED_MACRO_DATA     0x00  // Count data bytes follow (0 = end)
+#define NHD_OLED_MACRO_COMMANDS 0x40  // Count command bytes follow
+#define NHD_OLED_MACRO_REPEAT   0x80  // Send the next data byte count times
+#define NHD_OLED_MACRO_DELAY    0xC0  // Wait count milliseconds
+#define NHD_OLED_MACRO_END      0x00
+
+// Time allowed for the display to carry out a clear or home command, in
+// milliseconds.
+#define NHD_OLED_CLEAR_MS 10
+
+// Minimum SCLK (or parallel strobe) high/low times, in nanoseconds.
+// Conservative figures for the US2066 (1us minimum cycle).
+#define NHD_OLED_SCLK_HIGH_NS 500
+#define NHD_OLED_SCLK_LOW_NS  500
+
+// How long each setupCalibrate() measurement runs, in microseconds.
+#define NHD_OLED_CALIBRATE_US 2000
+
+// Pin write time assumed by the bus cost estimates until setupCalibrate()
+// has measured the real one, in nanoseconds - about what digitalWrite()
+// takes on a 16MHz AVR.
+#define NHD_OLED_PIN_WRITE_NS 3500
+
 class NHD_OLED
 {
   public:
@@ -83,15 +130,36 @@ class NHD_OLED
     //           byte columns = 16);
     void begin(byte pinSCLK, byte pinSDIN, byte rows = 2, 
                byte columns = 16);
+    void beginParallel(byte bus, byte pinD_C, byte pinE_WR, const byte *pinDB,
+                       byte rows = 2, byte columns = 16);
+    // beginI2C() and setupI2C() are defined in NHD_OLED_I2C.h - include it
+    // to use them. They take the TwoWire bus (usually Wire) as a template
+    // parameter so this header needn't name TwoWire, which some cores
+    // declare as a typedef or inside a namespace.
+    template <class Bus>
+    inline void beginI2C(Bus &wire, byte address = NHD_OLED_I2C_ADDRESS,
+                         byte rows = 2, byte columns = 16,
+                         unsigned long clock = NHD_OLED_I2C_CLOCK);
     void sendCommand(byte command);
     void sendData(byte data);
+    void macroPlay(const byte *macro);
+    void batchBegin();
+    void batchEnd();
     void setupDisplaySize(byte rows = 2, byte columns = 16);
     //void setupPins(byte pinSCLK, byte pinSDIN, byte pinC_S);
     void setupPins(byte pinSCLK, byte pinSDIN);
+    void setupParallel(byte bus, byte pinD_C, byte pinE_WR, const byte *pinDB);
+    template <class Bus>
+    inline void setupI2C(Bus &wire, byte address = NHD_OLED_I2C_ADDRESS,
+                         unsigned long clock = NHD_OLED_I2C_CLOCK);
     void setupInit();
+    void setupBusTiming(unsigned int minHighNs = NHD_OLED_SCLK_HIGH_NS,
+                        unsigned int minLowNs = NHD_OLED_SCLK_LOW_NS);
+    void setupCalibrate();
     void displayControl(byte display, byte cursor, byte block);
     void displayOn();
     void displayOff();
+    void displayDoubleHeight(byte mode);
     void textClear();
     void cursorHome();
     void cursorMoveToRow(byte rowNumber);
@@ -102,6 +170,7 @@ class NHD_OLED
     void print(char text);
     void print(char *text, byte len, byte r, byte c);
     void print(char text, byte r, byte c);
+    void fillRun(char ch, byte count);
     void textPrintCentered(char *text, byte length, byte row);
     void textPrintRightJustified(char *text, byte length, byte row);
     void textPrintTextFromProgmem(int ptrStringTableEntry);    
@@ -127,18 +196,93 @@ class NHD_OLED
     void leftToRight();
     void rightToLeft();
     void createChar(byte num, char* data);
+    void cgramWrite(byte slot, const byte *bitmap, byte fromProgmem = 0);
 
     // Pin Designations
     byte SCLK = 0;
     byte SDIN = 1;
     //byte C_S =  2;
+    byte D_C = 0;
+    byte E_WR = 0;
+    byte DB[8];
+
+    // Interface in use - one of the NHD_OLED_BUS_ values.
+    byte busType = NHD_OLED_BUS_SPI;
 
-    // Display Geometry
+    // Display Geometry - in double-height mode, DISP_ROWS counts the rows/
+    // lines as they appear, with each merged pair counting as one. Setting
+    // these directly instead of calling setupDisplaySize() works too, as
+    // long as it's done before setupInit().
     byte DISP_ROWS = 2;
     byte DISP_COLUMNS = 16;
+
+    // Double-height mode in use - one of the NHD_OLED_DOUBLE_ values.
+    byte doubleHeight = NHD_OLED_DOUBLE_NONE;
+
+    // Bus Timing - minimums from setupBusTiming(), measurements from
+    // setupCalibrate(), and the resulting hold-loop counts per SCLK phase.
+    unsigned int busHighNs = NHD_OLED_SCLK_HIGH_NS;
+    unsigned int busLowNs = NHD_OLED_SCLK_LOW_NS;
+    unsigned int pinWriteNs = 0;
+    unsigned int holdLoopNs = 0;
+    unsigned int holdHighLoops = 0;
+    unsigned int holdLowLoops = 0;
+
+    // Bus Costs - estimated time for a data byte and for a lone command byte
+    // on the current interface, in nanoseconds. Filled in by the setup
+    // functions and refined by setupCalibrate(); adjust by hand if the
+    // estimates are off.
+    unsigned long costDataNs = 0;
+    unsigned long costCommandNs = 0;
+
+    // Run Planning - shared by the frame and watch helpers.
+    byte runEnd(const char *before, const char *after, byte start,
+                byte width);
   private:
     // SPI Bit-Bang - This procedure shouldn't be called directly.
     void SPIBitBang(byte data, byte isCommand);    
+
+    // Parallel and I2C transports - also not meant to be called directly.
+    // The I2C transport is defined in NHD_OLED_I2C.h, and only reached
+    // through i2cWrite and i2cFlush, so sketches that don't include that
+    // header never link Wire.
+    void parallelWrite(byte data, byte isCommand);
+    inline void I2CWrite(byte data, byte isCommand);
+    inline void I2CRoom(byte count);
+    inline void I2CFlush();
+    void busWrite(byte data, byte isCommand);
+
+    // I2C transaction state. The bus is a TwoWire, only cast back to one in
+    // NHD_OLED_I2C.h.
+    void (NHD_OLED::*i2cWrite)(byte data, byte isCommand) = 0;
+    void (NHD_OLED::*i2cFlush)() = 0;
+    void *wire = 0;
+    byte i2cAddress = NHD_OLED_I2C_ADDRESS;
+    unsigned long i2cClock = NHD_OLED_I2C_CLOCK;
+    byte i2cState = 0;
+    byte i2cUsed = 0;
+    byte i2cHeld = 0;
+    byte i2cDC = 0;
+    byte batchDepth = 0;
+
+    // Parallel bus direct port access (AVR only).
+    byte parFast = 0;
+#if defined(__AVR__)
+    volatile uint8_t *parDBPort;
+    volatile uint8_t *parD_CPort;
+    volatile uint8_t *parE_WRPort;
+    uint8_t parD_CMask;
+    uint8_t parE_WRMask;
+#endif
+
+    // Rows/lines the display physically has, and the DDRAM row behind each
+    // row/line as it appears.
+    byte physicalRows = 2;
+    byte rowMap[4] = {0, 1, 2, 3};
+
+    void busTimingUpdate();
+    void busCostUpdate();
+    unsigned int holdLoopsFor(unsigned int minNs);
 };
 
 #endif
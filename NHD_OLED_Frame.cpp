@@ -0,0 +1,648 @@
+/*
+ * Newhaven Display Slim OLED Driver
+ * ---------------------------------
+ * 
+ * Shadow-Buffered Frame
+ * ---------------------
+ * 
+ * NHD_OLED_Frame keeps a copy of what's on the display alongside what the
+ * application wants there. Printing only changes the wanted copy; flush()
+ * then works out the cheapest way to bring the display up to date using the
+ * bus costs NHD_OLED estimates for the current interface, and sends it.
+ * 
+ * Three plans are weighed against each other:
+ * 
+ *   CELLS: rewrite only the runs of cells that changed. Nearby runs are
+ *          merged when resending the unchanged cells between them is
+ *          cheaper than a new set-address command.
+ *   ROWS:  rewrite each changed row in full.
+ *   CLEAR: send a hardware clear, wait for it, then write every non-blank
+ *          cell.
+ * 
+ * The plan chosen and the estimated cost of all three are kept in lastPlan
+ * so the choice can be checked in benchmarks.
+ * 
+ * The buffers are sized for the largest display the US2066 drives (20x4),
+ * 160 bytes in all. All writes to the display should go through the frame
+ * once it's in use, or it will lose track of what's shown.
+ * 
+ * 
+ * Software License Agreement (BSD License)
+ * 
+ * Copyright (c) 2015-2017 by Newhaven Display International, Inc.
+ * Copyright (c) 2017-2018 by Tom Honaker.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF 
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+
+
+#include "Arduino.h"
+#include "NHD_OLED_Frame.h"
+#include "NHD_OLED_Overlay.h"
+
+
+
+// NHD_OLED_Frame::begin
+//
+// Attaches the frame to an initialized display and clears both, so the
+// frame knows exactly what's shown.
+//
+// Parameters:
+//   display: display to draw on. begin() must already have been called.
+//
+void NHD_OLED_Frame::begin(NHD_OLED &display) {
+  oled = &display;
+
+  DISP_ROWS = oled->DISP_ROWS;
+  if (DISP_ROWS > NHD_OLED_FRAME_ROWS)
+    DISP_ROWS = NHD_OLED_FRAME_ROWS;
+
+  DISP_COLUMNS = oled->DISP_COLUMNS;
+  if (DISP_COLUMNS > NHD_OLED_FRAME_COLUMNS)
+    DISP_COLUMNS = NHD_OLED_FRAME_COLUMNS;
+
+  memset(shown, 0x20, sizeof(shown));
+  memset(wanted, 0x20, sizeof(wanted));
+  memset(&lastPlan, 0, sizeof(lastPlan));
+  memset(rowPriority, 0, sizeof(rowPriority));
+  overlays = 0;
+  cursorRow = 0;
+  cursorColumn = 0;
+
+  oled->textClear();
+}
+
+
+// NHD_OLED_Frame::textClear
+//
+// Blanks the whole frame. Nothing is sent until flush().
+//
+void NHD_OLED_Frame::textClear() {
+  memset(wanted, 0x20, sizeof(wanted));
+  cursorRow = 0;
+  cursorColumn = 0;
+}
+
+
+// NHD_OLED_Frame::textClearRow
+//
+// Blanks one row/line of the frame. Nothing is sent until flush().
+//
+// Parameters:
+//   rowNumber: row/line number to clear (zero-indexed, where 0 is topmost).
+//
+void NHD_OLED_Frame::textClearRow(byte rowNumber) {
+  if (rowNumber >= DISP_ROWS)
+    return;
+
+  memset(wanted[rowNumber], 0x20, NHD_OLED_FRAME_COLUMNS);
+}
+
+
+// NHD_OLED_Frame::cursorPos
+//
+// Moves the frame's write position. This doesn't touch the display's own
+// cursor.
+//
+// Parameters:
+//   row: row/line number (0-1/2/3).
+//   column: column number (0-16/20).
+//
+void NHD_OLED_Frame::cursorPos(byte row, byte column) {
+  cursorRow = row;
+  cursorColumn = column;
+}
+
+
+// NHD_OLED_Frame::print
+//
+// Writes text into the frame at the write position, which moves along with
+// the text. Text running past the end of the row/line is dropped. Nothing is
+// sent until flush().
+//
+// Parameters:
+//   text: text to display. This should be a full string if a length is
+//         provided.
+//   len: length of text to print, in characters.
+//
+void NHD_OLED_Frame::print(char *text, byte len) {
+  for (byte i = 0; i < len; i++)
+    print(text[i]);
+}
+
+
+// NHD_OLED_Frame::print - OVERLOAD
+//
+// Writes a single character into the frame at the write position.
+//
+// Parameters:
+//   text: text to display. This must be a single character.
+//
+void NHD_OLED_Frame::print(char text) {
+  if ((cursorRow < DISP_ROWS) and (cursorColumn < DISP_COLUMNS))
+    wanted[cursorRow][cursorColumn] = text;
+
+  if (cursorColumn < 255)
+    cursorColumn++;
+}
+
+
+// NHD_OLED_Frame::print - OVERLOAD
+//
+// Moves the write position, then writes text into the frame.
+//
+// Parameters:
+//   text: text to display. This should be a full string.
+//   len: length of text to print, in characters.
+//   r: row/line number (0-1/2/3).
+//   c: column number (0-16/20).
+//
+void NHD_OLED_Frame::print(char *text, byte len, byte r, byte c) {
+  cursorPos(r, c);
+  print(text, len);
+}
+
+
+// NHD_OLED_Frame::print - OVERLOAD
+//
+// Moves the write position, then writes a single character into the frame.
+//
+// Parameters:
+//   text: text to display. This must be a single character.
+//   r: row/line number (0-1/2/3).
+//   c: column number (0-16/20).
+//
+void NHD_OLED_Frame::print(char text, byte r, byte c) {
+  cursorPos(r, c);
+  print(text);
+}
+
+
+// NHD_OLED_Frame::target
+//
+// Returns the character that should end up in the given cell - the topmost
+// overlay's if one covers it, otherwise the frame's own.
+//
+char NHD_OLED_Frame::target(byte r, byte c) {
+  for (NHD_OLED_Overlay *o = overlays; o != 0; o = o->next)
+    if (o->covers(r, c))
+      return o->cells[(r - o->ROW) * o->DISP_COLUMNS + (c - o->COLUMN)];
+
+  return wanted[r][c];
+}
+
+
+// NHD_OLED_Frame::dirty
+//
+// Checks whether a cell needs writing.
+//
+// Parameters:
+//   r, c: cell to check.
+//   fromBlank: non-zero to compare against a cleared display rather than
+//              what's currently shown.
+//
+byte NHD_OLED_Frame::dirty(byte r, byte c, byte fromBlank) {
+  char current = fromBlank ? 0x20 : shown[r][c];
+
+  return target(r, c) != current;
+}
+
+
+// NHD_OLED_Frame::runEnd
+//
+// Finds where a run of cells needing writing ends, merging runs as
+// NHD_OLED::runEnd() does.
+//
+// Parameters:
+//   r, c: first cell of the run, which must need writing.
+//   fromBlank: non-zero to plan against a cleared display.
+//
+// Returns the column just past the end of the run.
+//
+byte NHD_OLED_Frame::runEnd(byte r, byte c, byte fromBlank) {
+  char before[NHD_OLED_FRAME_COLUMNS], after[NHD_OLED_FRAME_COLUMNS];
+
+  for (byte i = c; i < DISP_COLUMNS; i++) {
+    before[i] = fromBlank ? 0x20 : shown[r][i];
+    after[i] = target(r, i);
+  }
+
+  return oled->runEnd(before, after, c, DISP_COLUMNS);
+}
+
+
+// NHD_OLED_Frame::runSend
+//
+// Writes a run of cells to the display and marks them as shown.
+//
+// Parameters:
+//   r: row/line number.
+//   start: first column to write.
+//   end: column just past the last one to write.
+//
+void NHD_OLED_Frame::runSend(byte r, byte start, byte end) {
+  oled->cursorPos(r, start);
+  for (byte i = start; i < end; i++) {
+    shown[r][i] = target(r, i);
+    oled->sendData(shown[r][i]);
+  }
+}
+
+
+// NHD_OLED_Frame::cellsPass
+//
+// Walks the frame row by row, finding the runs of cells that need writing.
+//
+// Parameters:
+//   fromBlank: non-zero to plan against a cleared display.
+//   send: non-zero to actually write the runs, zero to just cost them.
+//   commands: if not null, incremented by the number of commands needed.
+//   data: if not null, incremented by the number of data bytes needed.
+//
+// Returns the estimated cost, in nanoseconds.
+//
+unsigned long NHD_OLED_Frame::cellsPass(byte fromBlank, byte send,
+                                        byte *commands, byte *data) {
+  unsigned long cost = 0;
+  byte r, c, end;
+
+  for (r = 0; r < DISP_ROWS; r++) {
+    c = 0;
+    while (c < DISP_COLUMNS) {
+      if (!dirty(r, c, fromBlank)) {
+        c++;
+        continue;
+      }
+
+      end = runEnd(r, c, fromBlank);
+
+      cost += oled->costCommandNs + (end - c) * oled->costDataNs;
+      if (commands != 0)
+        (*commands)++;
+      if (data != 0)
+        *data += end - c;
+
+      if (send)
+        runSend(r, c, end);
+
+      c = end;
+    }
+  }
+
+  return cost;
+}
+
+
+// NHD_OLED_Frame::plan
+//
+// Costs every way of bringing the display up to date and picks the cheapest.
+// Ties go to the plan that disturbs the display least: cells, then rows,
+// then a clear.
+//
+// Parameters:
+//   result: receives the chosen plan and the cost of every plan.
+//
+void NHD_OLED_Frame::plan(NHD_OLED_Plan &result) {
+  byte cellCommands = 0, cellData = 0, clearCommands = 1, clearData = 0;
+  byte rowCommands = 0;
+  byte r, c;
+
+  result.cellsNs = cellsPass(0, 0, &cellCommands, &cellData);
+
+  result.rowsNs = 0;
+  for (r = 0; r < DISP_ROWS; r++) {
+    for (c = 0; c < DISP_COLUMNS; c++)
+      if (dirty(r, c, 0))
+        break;
+
+    if (c < DISP_COLUMNS) {
+      rowCommands++;
+      result.rowsNs += oled->costCommandNs +
+                       DISP_COLUMNS * oled->costDataNs;
+    }
+  }
+
+  result.clearNs = oled->costCommandNs + NHD_OLED_CLEAR_MS * 1000000UL +
+                   cellsPass(1, 0, &clearCommands, &clearData);
+
+  if (cellCommands == 0) {
+    result.kind = NHD_OLED_PLAN_NONE;
+    result.commands = 0;
+    result.data = 0;
+  }
+  else if ((result.cellsNs <= result.rowsNs) and
+           (result.cellsNs <= result.clearNs)) {
+    result.kind = NHD_OLED_PLAN_CELLS;
+    result.commands = cellCommands;
+    result.data = cellData;
+  }
+  else if (result.rowsNs <= result.clearNs) {
+    result.kind = NHD_OLED_PLAN_ROWS;
+    result.commands = rowCommands;
+    result.data = rowCommands * DISP_COLUMNS;
+  }
+  else {
+    result.kind = NHD_OLED_PLAN_CLEAR;
+    result.commands = clearCommands;
+    result.data = clearData;
+  }
+}
+
+
+// NHD_OLED_Frame::send
+//
+// Carries out the plan in lastPlan.
+//
+void NHD_OLED_Frame::send() {
+  byte r, c;
+
+  switch (lastPlan.kind) {
+    case NHD_OLED_PLAN_CLEAR:
+      oled->textClear();
+      memset(shown, 0x20, sizeof(shown));
+
+      oled->batchBegin();
+      cellsPass(0, 1, 0, 0);
+      oled->batchEnd();
+      break;
+
+    case NHD_OLED_PLAN_ROWS:
+      oled->batchBegin();
+      for (r = 0; r < DISP_ROWS; r++) {
+        for (c = 0; c < DISP_COLUMNS; c++)
+          if (dirty(r, c, 0))
+            break;
+        if (c == DISP_COLUMNS)
+          continue;
+
+        runSend(r, 0, DISP_COLUMNS);
+      }
+      oled->batchEnd();
+      break;
+
+    case NHD_OLED_PLAN_CELLS:
+      oled->batchBegin();
+      cellsPass(0, 1, 0, 0);
+      oled->batchEnd();
+      break;
+  }
+}
+
+
+// NHD_OLED_Frame::flush
+//
+// Brings the display up to date using the cheapest plan. The plan used is
+// left in lastPlan.
+//
+void NHD_OLED_Frame::flush() {
+  plan(lastPlan);
+  send();
+}
+
+
+// NHD_OLED_Frame::flush - OVERLOAD
+//
+// Sends as much of the pending update as fits in a time budget, then
+// returns. If the cheapest plan is estimated to fit, it's used as-is.
+// Otherwise runs of changed cells are sent highest-priority row first (see
+// setRowPriority()), splitting the last run if only part of it fits, and
+// the rest is left for the next call. A clear is never started unless the
+// whole plan fits, since it blanks the display until it finishes.
+//
+// Time spent planning counts against the budget. Without cost estimates
+// (costDataNs of 0) the budget can't be split up, so the whole plan is sent.
+// lastPlan records what was actually sent.
+//
+// Parameters:
+//   maxMicros: time budget, in microseconds.
+//
+// Returns the number of cells still waiting to be sent.
+//
+unsigned int NHD_OLED_Frame::flush(unsigned long maxMicros) {
+  unsigned long started = micros(), elapsed, spentNs;
+  byte order[NHD_OLED_FRAME_ROWS];
+  byte i, j;
+
+  plan(lastPlan);
+  if (lastPlan.kind == NHD_OLED_PLAN_NONE)
+    return 0;
+
+  elapsed = micros() - started;
+  if ((oled->costDataNs == 0) or (planNs() / 1000 + elapsed < maxMicros)) {
+    send();
+    return 0;
+  }
+
+  spentNs = budgetStart(maxMicros, elapsed);
+
+  // Rows in priority order, top to bottom within a priority.
+  for (i = 0; i < DISP_ROWS; i++) {
+    for (j = i; (j > 0) and (rowPriority[order[j - 1]] < rowPriority[i]); j--)
+      order[j] = order[j - 1];
+    order[j] = i;
+  }
+
+  lastPlan.kind = NHD_OLED_PLAN_CELLS;
+  lastPlan.commands = 0;
+  lastPlan.data = 0;
+
+  oled->batchBegin();
+  for (i = 0; i < DISP_ROWS; i++)
+    if (rowSend(order[i], started, maxMicros, spentNs))
+      break;
+  oled->batchEnd();
+
+  return pending();
+}
+
+
+// NHD_OLED_Frame::planNs
+//
+// Returns the estimated cost of the plan in lastPlan, in nanoseconds.
+//
+unsigned long NHD_OLED_Frame::planNs() {
+  switch (lastPlan.kind) {
+    case NHD_OLED_PLAN_NONE:
+      return 0;
+    case NHD_OLED_PLAN_CELLS:
+      return lastPlan.cellsNs;
+    case NHD_OLED_PLAN_ROWS:
+      return lastPlan.rowsNs;
+    default:
+      return lastPlan.clearNs;
+  }
+}
+
+
+// NHD_OLED_Frame::budgetStart
+//
+// Sets up a budgeted flush once planning is done. The budget is capped so
+// the conversion to nanoseconds can't overflow.
+//
+// Parameters:
+//   maxMicros: time budget, in microseconds - capped in place.
+//   elapsed: time already spent planning, in microseconds.
+//
+// Returns the time already spent, in nanoseconds.
+//
+unsigned long NHD_OLED_Frame::budgetStart(unsigned long &maxMicros,
+                                          unsigned long elapsed) {
+  if (maxMicros > NHD_OLED_BUDGET_MAX_US)
+    maxMicros = NHD_OLED_BUDGET_MAX_US;
+
+  return ((elapsed < maxMicros) ? elapsed : maxMicros) * 1000;
+}
+
+
+// NHD_OLED_Frame::rowSend
+//
+// Sends one row's runs of changed cells for a budgeted flush, splitting the
+// last run if only part of it fits, and adds them to lastPlan. The time
+// already used is the larger of the time since the flush started and
+// spentNs, the estimated cost of everything queued so far, which each run
+// sent adds to. Both are needed: over I2C, runs are only buffered until the
+// batch ends, so micros() alone undercounts.
+//
+// Parameters:
+//   r: row/line number.
+//   started: micros() when the flush started.
+//   maxMicros: time budget, in microseconds - at most NHD_OLED_BUDGET_MAX_US.
+//   spentNs: estimated cost of what's been queued so far, in nanoseconds.
+//
+// Returns 1 once the budget is used up, otherwise 0.
+//
+byte NHD_OLED_Frame::rowSend(byte r, unsigned long started,
+                             unsigned long maxMicros, unsigned long &spentNs) {
+  unsigned long budgetNs = maxMicros * 1000, elapsed, usedNs, fit;
+  byte c = 0, end;
+
+  while (c < DISP_COLUMNS) {
+    if (!dirty(r, c, 0)) {
+      c++;
+      continue;
+    }
+
+    elapsed = micros() - started;
+    if (elapsed > maxMicros)
+      elapsed = maxMicros;
+    usedNs = elapsed * 1000;
+    if (usedNs < spentNs)
+      usedNs = spentNs;
+
+    if (budgetNs < usedNs + oled->costCommandNs + oled->costDataNs)
+      return 1;
+
+    end = runEnd(r, c, 0);
+    fit = (budgetNs - usedNs - oled->costCommandNs) / oled->costDataNs;
+    if ((unsigned long)(end - c) > fit)
+      end = c + fit;
+
+    runSend(r, c, end);
+    spentNs += oled->costCommandNs + (end - c) * oled->costDataNs;
+    lastPlan.commands++;
+    lastPlan.data += end - c;
+
+    c = end;
+  }
+
+  return 0;
+}
+
+
+// NHD_OLED_Frame::pending
+//
+// Returns the number of cells that differ from what the display shows.
+//
+unsigned int NHD_OLED_Frame::pending() {
+  unsigned int count = 0;
+
+  for (byte r = 0; r < DISP_ROWS; r++)
+    for (byte c = 0; c < DISP_COLUMNS; c++)
+      if (dirty(r, c, 0))
+        count++;
+
+  return count;
+}
+
+
+// NHD_OLED_Frame::setRowPriority
+//
+// Sets the order rows are sent in when flush() is given a time budget.
+// Higher priorities go first, and rows with the same priority go top to
+// bottom. Every row starts at priority 0.
+//
+// Parameters:
+//   row: row/line number (0-1/2/3).
+//   priority: 0-255, where 255 is sent first.
+//
+void NHD_OLED_Frame::setRowPriority(byte row, byte priority) {
+  if (row < NHD_OLED_FRAME_ROWS)
+    rowPriority[row] = priority;
+}
+
+
+// NHD_OLED_Frame::show
+//
+// Shows an overlay on top of everything else, or brings it to the top if
+// it's already showing. Nothing is sent until flush().
+//
+// Parameters:
+//   overlay: overlay to show. It must stay in scope while it's showing.
+//
+void NHD_OLED_Frame::show(NHD_OLED_Overlay &overlay) {
+  hide(overlay);
+
+  overlay.next = overlays;
+  overlays = &overlay;
+}
+
+
+// NHD_OLED_Frame::hide
+//
+// Takes an overlay off the frame. The next flush() puts back whatever it
+// covered, and nothing else.
+//
+// Parameters:
+//   overlay: overlay to hide. Hiding one that isn't showing does nothing.
+//
+void NHD_OLED_Frame::hide(NHD_OLED_Overlay &overlay) {
+  NHD_OLED_Overlay **link = &overlays;
+
+  while ((*link != 0) and (*link != &overlay))
+    link = &(*link)->next;
+
+  if (*link != 0)
+    *link = overlay.next;
+
+  overlay.next = 0;
+}
+
+
+
+/*
+ * End of file!
+ */
\ No newline at end of file
@@ -0,0 +1,157 @@
+/*
+ * Newhaven Display Slim OLED Driver
+ * ---------------------------------
+ * 
+ * Shadow-Buffered Frame
+ * ---------------------
+ * 
+ * NHD_OLED_Frame keeps a copy of what's on the display alongside what the
+ * application wants there. Printing only changes the wanted copy; flush()
+ * then works out the cheapest way to bring the display up to date using the
+ * bus costs NHD_OLED estimates for the current interface, and sends it.
+ * 
+ * Three plans are weighed against each other:
+ * 
+ *   CELLS: rewrite only the runs of cells that changed. Nearby runs are
+ *          merged when resending the unchanged cells between them is
+ *          cheaper than a new set-address command.
+ *   ROWS:  rewrite each changed row in full.
+ *   CLEAR: send a hardware clear, wait for it, then write every non-blank
+ *          cell.
+ * 
+ * The plan chosen and the estimated cost of all three are kept in lastPlan
+ * so the choice can be checked in benchmarks.
+ * 
+ * The buffers are sized for the largest display the US2066 drives (20x4),
+ * 160 bytes in all. All writes to the display should go through the frame
+ * once it's in use, or it will lose track of what's shown.
+ * 
+ * 
+ * Software License Agreement (BSD License)
+ * 
+ * Copyright (c) 2015-2017 by Newhaven Display International, Inc.
+ * Copyright (c) 2017-2018 by Tom Honaker.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF 
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+
+
+#ifndef NHD_OLED_FRAME_H
+#define NHD_OLED_FRAME_H
+
+#include "Arduino.h"
+#include "NHD_OLED_Driver.h"
+
+// Largest geometry the frame buffers hold - the US2066's 20x4.
+#define NHD_OLED_FRAME_ROWS    4
+#define NHD_OLED_FRAME_COLUMNS 20
+
+// Longest budget a budgeted flush() works to, in microseconds. Anything
+// longer is treated as this - far more than a full repaint takes.
+#define NHD_OLED_BUDGET_MAX_US 4000000UL
+
+// Update plans.
+#define NHD_OLED_PLAN_NONE  0  // Nothing to send
+#define NHD_OLED_PLAN_CELLS 1  // Rewrite changed runs of cells
+#define NHD_OLED_PLAN_ROWS  2  // Rewrite changed rows in full
+#define NHD_OLED_PLAN_CLEAR 3  // Hardware clear, then write non-blank cells
+
+class NHD_OLED_Overlay;
+
+// The plan flush() chose, with the estimated cost of every plan.
+struct NHD_OLED_Plan {
+  byte kind;              // One of the NHD_OLED_PLAN_ values
+  byte commands;          // Commands the chosen plan sends
+  byte data;              // Data bytes the chosen plan sends
+  unsigned long cellsNs;  // Estimated cost of each plan, in nanoseconds
+  unsigned long rowsNs;
+  unsigned long clearNs;
+};
+
+class NHD_OLED_Frame
+{
+  public:
+    void begin(NHD_OLED &display);
+    void textClear();
+    void textClearRow(byte rowNumber);
+    void cursorPos(byte row, byte column);
+    void print(char *text, byte len);
+    void print(char text);
+    void print(char *text, byte len, byte r, byte c);
+    void print(char text, byte r, byte c);
+    void plan(NHD_OLED_Plan &result);
+    void flush();
+    unsigned int flush(unsigned long maxMicros);
+    unsigned int pending();
+    void setRowPriority(byte row, byte priority);
+    void show(NHD_OLED_Overlay &overlay);
+    void hide(NHD_OLED_Overlay &overlay);
+
+    // The plan used by the most recent flush().
+    NHD_OLED_Plan lastPlan;
+
+    // Frame Geometry - the display's, capped to what the buffers hold.
+    byte DISP_ROWS = 0;
+    byte DISP_COLUMNS = 0;
+  private:
+    char target(byte r, byte c);
+    byte dirty(byte r, byte c, byte fromBlank);
+    byte runEnd(byte r, byte c, byte fromBlank);
+    void runSend(byte r, byte start, byte end);
+    unsigned long cellsPass(byte fromBlank, byte send, byte *commands,
+                            byte *data);
+    void send();
+    unsigned long planNs();
+    static unsigned long budgetStart(unsigned long &maxMicros,
+                                     unsigned long elapsed);
+    byte rowSend(byte r, unsigned long started, unsigned long maxMicros,
+                 unsigned long &spentNs);
+
+    NHD_OLED *oled = 0;
+    byte cursorRow = 0;
+    byte cursorColumn = 0;
+
+    // What the display is showing, and what the application wants shown.
+    char shown[NHD_OLED_FRAME_ROWS][NHD_OLED_FRAME_COLUMNS];
+    char wanted[NHD_OLED_FRAME_ROWS][NHD_OLED_FRAME_COLUMNS];
+
+    // Overlays being shown, topmost first.
+    NHD_OLED_Overlay *overlays = 0;
+
+    // Order rows are sent in by a budgeted flush().
+    byte rowPriority[NHD_OLED_FRAME_ROWS];
+
+    friend class NHD_OLED_Canvas;
+};
+
+#endif
+
+
+
+/*
+ * End of file!
+ */
\ No newline at end of file
@@ -0,0 +1,138 @@
+/*
+ * Newhaven Display Slim OLED Driver
+ * ---------------------------------
+ * 
+ * Animated Glyphs
+ * ---------------
+ * 
+ * NHD_OLED_Glyph animates one of the display's eight custom characters by
+ * rewriting its bitmap in CGRAM. Every cell showing that character changes
+ * at once, so each animation frame costs one command and eight data bytes
+ * however many times the glyph appears on screen - handy for spinners,
+ * blinking alarm icons and activity indicators.
+ * 
+ * The frames live in program memory, eight bytes (rows, top first, five
+ * bits wide) per frame.
+ * 
+ * 
+ * Software License Agreement (BSD License)
+ * 
+ * Copyright (c) 2015-2017 by Newhaven Display International, Inc.
+ * Copyright (c) 2017-2018 by Tom Honaker.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF 
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+
+
+#include "Arduino.h"
+#include "NHD_OLED_Glyph.h"
+
+
+
+// NHD_OLED_Glyph::begin
+//
+// Sets up the animation and uploads its first frame.
+//
+// Parameters:
+//   display: display to animate on. begin() must already have been called.
+//   slot: custom character slot to use (0-7).
+//   frames: PROGMEM array of count * 8 bytes, one 5x8 bitmap per frame.
+//   count: number of frames.
+//   intervalMs: time between frames, in milliseconds.
+//
+void NHD_OLED_Glyph::begin(NHD_OLED &display, byte slot, const byte *frames,
+                           byte count, unsigned int intervalMs) {
+  oled = &display;
+  this->slot = slot & 0x07;
+  this->frames = frames;
+  this->count = count;
+  this->intervalMs = intervalMs;
+
+  show(0);
+}
+
+
+// NHD_OLED_Glyph::tick
+//
+// Moves on to the next frame once the interval has passed. Call this from
+// loop(). Uploading a frame leaves the display's address counter in CGRAM,
+// so move the cursor before printing again.
+//
+// Returns non-zero if a frame was uploaded.
+//
+byte NHD_OLED_Glyph::tick() {
+  unsigned long now = millis();
+
+  if ((count < 2) or (now - lastMs < intervalMs))
+    return 0;
+
+  frame++;
+  if (frame >= count)
+    frame = 0;
+
+  upload();
+
+  // Keep to the interval's cadence, but don't try to catch up after a stall.
+  lastMs += intervalMs;
+  if (now - lastMs >= intervalMs)
+    lastMs = now;
+
+  return 1;
+}
+
+
+// NHD_OLED_Glyph::show
+//
+// Jumps straight to the given frame and restarts the interval.
+//
+// Parameters:
+//   frame: frame number (zero-indexed).
+//
+void NHD_OLED_Glyph::show(byte frame) {
+  this->frame = (frame < count) ? frame : 0;
+
+  upload();
+  lastMs = millis();
+}
+
+
+// NHD_OLED_Glyph::upload
+//
+// Copies the current frame from program memory into the glyph's CGRAM slot.
+//
+void NHD_OLED_Glyph::upload() {
+  if (count == 0)
+    return;
+
+  oled->cgramWrite(slot, frames + frame * 8, 1);
+}
+
+
+
+/*
+ * End of file!
+ */
\ No newline at end of file
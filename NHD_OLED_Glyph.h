@@ -0,0 +1,87 @@
+/*
+ * Newhaven Display Slim OLED Driver
+ * ---------------------------------
+ * 
+ * Animated Glyphs
+ * ---------------
+ * 
+ * NHD_OLED_Glyph animates one of the display's eight custom characters by
+ * rewriting its bitmap in CGRAM. Every cell showing that character changes
+ * at once, so each animation frame costs one command and eight data bytes
+ * however many times the glyph appears on screen - handy for spinners,
+ * blinking alarm icons and activity indicators.
+ * 
+ * The frames live in program memory, eight bytes (rows, top first, five
+ * bits wide) per frame.
+ * 
+ * 
+ * Software License Agreement (BSD License)
+ * 
+ * Copyright (c) 2015-2017 by Newhaven Display International, Inc.
+ * Copyright (c) 2017-2018 by Tom Honaker.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF 
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+
+
+#ifndef NHD_OLED_GLYPH_H
+#define NHD_OLED_GLYPH_H
+
+#include "Arduino.h"
+#include "NHD_OLED_Driver.h"
+
+class NHD_OLED_Glyph
+{
+  public:
+    void begin(NHD_OLED &display, byte slot, const byte *frames, byte count,
+               unsigned int intervalMs);
+    byte tick();
+    void show(byte frame);
+
+    // Custom character slot (0-7) - print this character code to show the
+    // glyph.
+    byte slot = 0;
+
+    // Frame currently in CGRAM.
+    byte frame = 0;
+  private:
+    void upload();
+
+    NHD_OLED *oled = 0;
+    const byte *frames = 0;
+    byte count = 0;
+    unsigned int intervalMs = 0;
+    unsigned long lastMs = 0;
+};
+
+#endif
+
+
+
+/*
+ * End of file!
+ */
\ No newline at end of file
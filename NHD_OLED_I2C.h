@@ -0,0 +1,246 @@
+/*
+ * Newhaven Display Slim OLED Driver
+ * ---------------------------------
+ * 
+ * I2C Transport
+ * -------------
+ * 
+ * The I2C transport lives in this header rather than in the library's
+ * source files so that only sketches which use it pull in Wire. Include it
+ * ahead of calling beginI2C() or setupI2C():
+ * 
+ *   #include <Wire.h>
+ *   #include <NHD_OLED_I2C.h>
+ * 
+ * 
+ * Software License Agreement (BSD License)
+ * 
+ * Copyright (c) 2015-2017 by Newhaven Display International, Inc.
+ * Copyright (c) 2017-2018 by Tom Honaker.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF 
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+
+
+#ifndef NHD_OLED_I2C_H
+#define NHD_OLED_I2C_H
+
+#include "Arduino.h"
+#include <Wire.h>
+#include "NHD_OLED_Driver.h"
+
+
+
+// Largest transaction Wire can buffer, not counting the address byte.
+#if defined(BUFFER_LENGTH)
+#define NHD_OLED_I2C_BUFFER BUFFER_LENGTH
+#elif defined(I2C_BUFFER_LENGTH)
+#define NHD_OLED_I2C_BUFFER I2C_BUFFER_LENGTH
+#else
+#define NHD_OLED_I2C_BUFFER 32
+#endif
+
+// I2C control byte bits. Co = 1 means one byte follows and then another
+// control byte; Co = 0 means every remaining byte in the transaction is of
+// the same type. D/C# = 1 marks data, 0 marks commands.
+#define NHD_OLED_I2C_CO   0x80
+#define NHD_OLED_I2C_DATA 0x40
+
+// I2C transaction states.
+#define NHD_OLED_I2C_IDLE    0  // No transaction open
+#define NHD_OLED_I2C_OPEN    1  // Transaction open, nothing held back
+#define NHD_OLED_I2C_PENDING 2  // One byte held back, framing undecided
+#define NHD_OLED_I2C_STREAM  3  // Co = 0 control byte sent, streaming
+
+
+
+// NHD_OLED::beginI2C
+//
+// Performs all required initialization steps for a display strapped for I2C,
+// in a single command.
+//
+// Parameters:
+//    wire: I2C bus the display is on, usually Wire.
+//    address: display's 7-bit I2C address - 0x3C, or 0x3D with SA0 high.
+//    rows: number of rows/lines on the display.
+//    columns: number of columns/characters per line on the display.
+//    clock: I2C bus speed, in Hz.
+//
+template <class Bus>
+inline void NHD_OLED::beginI2C(Bus &wire, byte address, byte rows,
+                               byte columns, unsigned long clock) {
+    setupI2C(wire, address, clock);
+    setupDisplaySize(rows, columns);
+    setupInit();
+}
+
+
+// NHD_OLED::I2CWrite
+//
+// Queues a byte into the current I2C transaction, choosing the cheapest
+// control-byte framing the US2066 allows. A run of same-type bytes shares a
+// single Co = 0 control byte; a byte followed by one of the other type gets
+// its own Co = 1 control byte. Since nothing can follow a Co = 0 run but
+// more of the same type, a type change after a run closes the transaction.
+// Transactions are also split to fit Wire's buffer.
+//
+// The last byte is held back until the next one shows what framing it
+// needs, so outside a batch the transaction is flushed straight away.
+//
+// Parameters:
+//   data: byte to send to display
+//   isCommand: command/data flag, where 0 = data and <>0 = command
+//
+inline void NHD_OLED::I2CWrite(byte data, byte isCommand) {
+  TwoWire *bus = (TwoWire *)wire;
+  byte dc = (isCommand == 0) ? NHD_OLED_I2C_DATA : 0x00;
+
+  // Still streaming the same type: just add the byte.
+  if ((i2cState == NHD_OLED_I2C_STREAM) and (dc == i2cDC)) {
+    I2CRoom(1);
+    bus->write(data);
+    i2cUsed++;
+    return;
+  }
+
+  // A type change ends a stream, and with it the transaction.
+  if (i2cState == NHD_OLED_I2C_STREAM)
+    I2CFlush();
+
+  if (i2cState == NHD_OLED_I2C_PENDING) {
+    if (dc == i2cDC) {
+      // Two in a row - stream them under a single control byte.
+      I2CRoom(3);
+      bus->write(dc);
+      bus->write(i2cHeld);
+      bus->write(data);
+      i2cUsed += 3;
+      i2cState = NHD_OLED_I2C_STREAM;
+      return;
+    }
+
+    // Types alternate - frame the held byte on its own.
+    bus->write(NHD_OLED_I2C_CO | i2cDC);
+    bus->write(i2cHeld);
+    i2cUsed += 2;
+    i2cState = NHD_OLED_I2C_OPEN;
+  }
+
+  if (i2cState == NHD_OLED_I2C_IDLE) {
+    bus->beginTransmission(i2cAddress);
+    i2cUsed = 0;
+  }
+
+  // Hold this byte back, keeping room to send it with its control byte.
+  i2cState = NHD_OLED_I2C_OPEN;
+  I2CRoom(2);
+  i2cHeld = data;
+  i2cDC = dc;
+  i2cState = NHD_OLED_I2C_PENDING;
+
+  if (batchDepth == 0)
+    I2CFlush();
+}
+
+
+// NHD_OLED::I2CRoom
+//
+// Makes sure the open transaction has room for the given number of bytes,
+// ending it and starting another if not. A stream carries on in the new
+// transaction under a fresh control byte.
+//
+// Parameters:
+//   count: number of bytes about to be written.
+//
+inline void NHD_OLED::I2CRoom(byte count) {
+  TwoWire *bus = (TwoWire *)wire;
+
+  if (i2cUsed + count <= NHD_OLED_I2C_BUFFER)
+    return;
+
+  bus->endTransmission();
+  bus->beginTransmission(i2cAddress);
+  i2cUsed = 0;
+
+  if (i2cState == NHD_OLED_I2C_STREAM) {
+    bus->write(i2cDC);
+    i2cUsed++;
+  }
+}
+
+
+// NHD_OLED::I2CFlush
+//
+// Sends any held-back byte and ends the open I2C transaction, if any.
+//
+inline void NHD_OLED::I2CFlush() {
+  TwoWire *bus = (TwoWire *)wire;
+
+  if (i2cState == NHD_OLED_I2C_IDLE)
+    return;
+
+  if (i2cState == NHD_OLED_I2C_PENDING) {
+    bus->write(i2cDC);
+    bus->write(i2cHeld);
+  }
+
+  bus->endTransmission();
+  i2cState = NHD_OLED_I2C_IDLE;
+}
+
+
+// NHD_OLED::setupI2C
+//
+// Switches the driver to the display's I2C interface. The display's BS pins
+// must be strapped for I2C; see its datasheet.
+//
+// Parameters:
+//    wire: I2C bus the display is on, usually Wire.
+//    address: display's 7-bit I2C address - 0x3C, or 0x3D with SA0 high.
+//    clock: I2C bus speed, in Hz.
+//
+template <class Bus>
+inline void NHD_OLED::setupI2C(Bus &wire, byte address, unsigned long clock) {
+  // Only a TwoWire will do, whatever type the template was given.
+  TwoWire *bus = &wire;
+
+  this->wire = bus;
+  i2cAddress = address;
+  i2cClock = clock;
+  i2cState = NHD_OLED_I2C_IDLE;
+  i2cWrite = &NHD_OLED::I2CWrite;
+  i2cFlush = &NHD_OLED::I2CFlush;
+  busType = NHD_OLED_BUS_I2C;
+
+  bus->begin();
+  bus->setClock(clock);
+  busCostUpdate();
+
+  delay(30);
+}
+
+#endif
@@ -0,0 +1,323 @@
+/*
+ * Newhaven Display Slim OLED Driver
+ * ---------------------------------
+ * 
+ * Menus
+ * -----
+ * 
+ * NHD_OLED_Menu drives a scrolling menu whose tree and labels are kept
+ * entirely in program memory - each list knows its parent, so going back up
+ * needs no stack. The engine itself only remembers which list is open,
+ * which item is selected and which item is at the top of the window, so its
+ * RAM use is the same however big the menu gets.
+ * 
+ * Every change is drawn by comparing each row as it was with the row as it
+ * should be, straight out of flash, and sending only the span between the
+ * first and last characters that differ. Moving the selection within the
+ * window sends just the old and new markers; scrolling sends just the parts
+ * of each label that changed.
+ * 
+ * 
+ * Software License Agreement (BSD License)
+ * 
+ * Copyright (c) 2015-2017 by Newhaven Display International, Inc.
+ * Copyright (c) 2017-2018 by Tom Honaker.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF 
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+
+
+#include "Arduino.h"
+#include "NHD_OLED_Menu.h"
+
+
+
+// NHD_OLED_Menu::begin
+//
+// Opens the top-level list with its first entry selected and draws it.
+//
+// Parameters:
+//   display: display to draw on. begin() must already have been called.
+//   root: top-level PROGMEM list.
+//   firstRow: topmost row/line of the menu window. A window starting below
+//             the display is empty, and nothing is drawn.
+//   rows: number of rows/lines in the window, or 0 for the rest of the
+//         display.
+//
+void NHD_OLED_Menu::begin(NHD_OLED &display, const NHD_OLED_MenuList *root,
+                          byte firstRow, byte rows) {
+  oled = &display;
+  this->firstRow = firstRow;
+  this->rows = rows;
+  if (firstRow >= oled->DISP_ROWS)
+    this->rows = 0;
+  else if ((rows == 0) or (firstRow + rows > oled->DISP_ROWS))
+    this->rows = oled->DISP_ROWS - firstRow;
+
+  list = root;
+  selected = 0;
+  top = 0;
+
+  redraw();
+}
+
+
+// NHD_OLED_Menu::redraw
+//
+// Draws the whole menu window, for when something else has drawn over it.
+//
+void NHD_OLED_Menu::redraw() {
+  update(list, top, selected, 1);
+}
+
+
+// NHD_OLED_Menu::next
+//
+// Selects the next entry, scrolling if needed. Does nothing on the last
+// entry.
+//
+void NHD_OLED_Menu::next() {
+  if (selected + 1 < pgm_read_byte(&list->count))
+    moveTo(list, selected + 1);
+}
+
+
+// NHD_OLED_Menu::previous
+//
+// Selects the previous entry, scrolling if needed. Does nothing on the
+// first entry.
+//
+void NHD_OLED_Menu::previous() {
+  if (selected > 0)
+    moveTo(list, selected - 1);
+}
+
+
+// NHD_OLED_Menu::enter
+//
+// Opens the selected entry's list if it has one.
+//
+// Returns the selected entry's id if it's a leaf, or 0 if a list was
+// opened.
+//
+byte NHD_OLED_Menu::enter() {
+  const NHD_OLED_MenuItem *item =
+    (const NHD_OLED_MenuItem *)pgm_read_ptr(&list->items) + selected;
+  const NHD_OLED_MenuList *submenu =
+    (const NHD_OLED_MenuList *)pgm_read_ptr(&item->submenu);
+
+  if (submenu == 0)
+    return pgm_read_byte(&item->id);
+
+  moveTo(submenu, 0);
+
+  return 0;
+}
+
+
+// NHD_OLED_Menu::back
+//
+// Returns to the parent list, with the entry that opened this one selected.
+// Does nothing at the top level.
+//
+void NHD_OLED_Menu::back() {
+  const NHD_OLED_MenuList *parent =
+    (const NHD_OLED_MenuList *)pgm_read_ptr(&list->parent);
+
+  if (parent != 0)
+    moveTo(parent, pgm_read_byte(&list->parentItem));
+}
+
+
+// NHD_OLED_Menu::selectedId
+//
+// Returns the id of the selected entry.
+//
+byte NHD_OLED_Menu::selectedId() {
+  const NHD_OLED_MenuItem *item =
+    (const NHD_OLED_MenuItem *)pgm_read_ptr(&list->items) + selected;
+
+  return pgm_read_byte(&item->id);
+}
+
+
+// NHD_OLED_Menu::moveTo
+//
+// Changes the open list and selection, scrolling just far enough to keep the
+// selection in the window, then draws the difference.
+//
+// Parameters:
+//   newList: list to open.
+//   newSelected: entry to select.
+//
+void NHD_OLED_Menu::moveTo(const NHD_OLED_MenuList *newList,
+                           byte newSelected) {
+  const NHD_OLED_MenuList *oldList = list;
+  byte oldTop = top, oldSelected = selected;
+
+  if (newList != list)
+    top = 0;
+
+  list = newList;
+  selected = newSelected;
+
+  if (selected < top)
+    top = selected;
+  else if (selected >= top + rows)
+    top = selected - rows + 1;
+
+  update(oldList, oldTop, oldSelected, 0);
+}
+
+
+// NHD_OLED_Menu::label
+//
+// Returns the PROGMEM label of an entry, or 0 past the end of the list.
+//
+// Parameters:
+//   from: list holding the entry.
+//   item: entry number.
+//
+const char *NHD_OLED_Menu::label(const NHD_OLED_MenuList *from, byte item) {
+  const NHD_OLED_MenuItem *items;
+
+  if (item >= pgm_read_byte(&from->count))
+    return 0;
+
+  items = (const NHD_OLED_MenuItem *)pgm_read_ptr(&from->items);
+
+  return (const char *)pgm_read_ptr(&items[item].label);
+}
+
+
+// NHD_OLED_Menu::length
+//
+// Returns the length of a PROGMEM label, counting no further than a limit.
+//
+// Parameters:
+//   text: the label, or 0 for an empty row.
+//   limit: longest length worth counting.
+//
+byte NHD_OLED_Menu::length(const char *text, byte limit) {
+  byte len = 0;
+
+  if (text == 0)
+    return 0;
+
+  while ((len < limit) and (pgm_read_byte(text + len) != 0))
+    len++;
+
+  return len;
+}
+
+
+// NHD_OLED_Menu::cell
+//
+// Works out one character of a menu row: the marker column, then the label,
+// then spaces.
+//
+// Parameters:
+//   text: the row's PROGMEM label, or 0 for an empty row.
+//   len: length of the label.
+//   marked: non-zero if the row's entry is selected.
+//   column: column to work out.
+//
+char NHD_OLED_Menu::cell(const char *text, byte len, byte marked,
+                         byte column) {
+  if (column == 0)
+    return marked ? NHD_OLED_MENU_MARKER : 0x20;
+
+  if (column > len)
+    return 0x20;
+
+  return pgm_read_byte(text + column - 1);
+}
+
+
+// NHD_OLED_Menu::update
+//
+// Compares each row of the window as it was with how it should be now, and
+// sends only the span from the first to the last character that differ.
+//
+// Parameters:
+//   oldList, oldTop, oldSelected: menu state the display is showing.
+//   all: non-zero to send every row in full.
+//
+void NHD_OLED_Menu::update(const NHD_OLED_MenuList *oldList, byte oldTop,
+                           byte oldSelected, byte all) {
+  const char *oldText, *newText;
+  byte row, column, first, last, oldLen, newLen;
+  byte oldMarked, newMarked;
+  byte columns = oled->DISP_COLUMNS;
+
+  oled->batchBegin();
+
+  for (row = 0; row < rows; row++) {
+    oldText = label(oldList, oldTop + row);
+    newText = label(list, top + row);
+    oldMarked = (oldText != 0) and (oldTop + row == oldSelected);
+    newMarked = (newText != 0) and (top + row == selected);
+    newLen = length(newText, columns - 1);
+
+    first = 0;
+    last = columns;
+
+    if (!all) {
+      // Same label and same marker - nothing to send.
+      if ((oldText == newText) and (oldMarked == newMarked))
+        continue;
+
+      oldLen = length(oldText, columns - 1);
+
+      // Trim the matching characters off both ends.
+      while ((first < last) and
+             (cell(oldText, oldLen, oldMarked, first) ==
+              cell(newText, newLen, newMarked, first)))
+        first++;
+
+      while ((last > first) and
+             (cell(oldText, oldLen, oldMarked, last - 1) ==
+              cell(newText, newLen, newMarked, last - 1)))
+        last--;
+
+      if (first == last)
+        continue;
+    }
+
+    oled->cursorPos(firstRow + row, first);
+    for (column = first; column < last; column++)
+      oled->sendData(cell(newText, newLen, newMarked, column));
+  }
+
+  oled->batchEnd();
+}
+
+
+
+/*
+ * End of file!
+ */
\ No newline at end of file
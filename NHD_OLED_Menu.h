@@ -0,0 +1,115 @@
+/*
+ * Newhaven Display Slim OLED Driver
+ * ---------------------------------
+ * 
+ * Menus
+ * -----
+ * 
+ * NHD_OLED_Menu drives a scrolling menu whose tree and labels are kept
+ * entirely in program memory - each list knows its parent, so going back up
+ * needs no stack. The engine itself only remembers which list is open,
+ * which item is selected and which item is at the top of the window, so its
+ * RAM use is the same however big the menu gets.
+ * 
+ * Every change is drawn by comparing each row as it was with the row as it
+ * should be, straight out of flash, and sending only the span between the
+ * first and last characters that differ. Moving the selection within the
+ * window sends just the old and new markers; scrolling sends just the parts
+ * of each label that changed.
+ * 
+ * 
+ * Software License Agreement (BSD License)
+ * 
+ * Copyright (c) 2015-2017 by Newhaven Display International, Inc.
+ * Copyright (c) 2017-2018 by Tom Honaker.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF 
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+
+
+#ifndef NHD_OLED_MENU_H
+#define NHD_OLED_MENU_H
+
+#include "Arduino.h"
+#include "NHD_OLED_Driver.h"
+
+// Character drawn in the first column of the selected row.
+#define NHD_OLED_MENU_MARKER '>'
+
+struct NHD_OLED_MenuList;
+
+// A menu entry, stored in PROGMEM.
+struct NHD_OLED_MenuItem {
+  const char *label;                  // PROGMEM string
+  const NHD_OLED_MenuList *submenu;   // List this entry opens, or 0
+  byte id;                            // Returned by enter() for a leaf
+};
+
+// A list of menu entries, stored in PROGMEM.
+struct NHD_OLED_MenuList {
+  const NHD_OLED_MenuList *parent;    // List back() returns to, or 0
+  byte parentItem;                    // Entry in the parent that opens this
+  byte count;                         // Number of entries
+  const NHD_OLED_MenuItem *items;     // PROGMEM array of count entries
+};
+
+class NHD_OLED_Menu
+{
+  public:
+    void begin(NHD_OLED &display, const NHD_OLED_MenuList *root,
+               byte firstRow = 0, byte rows = 0);
+    void redraw();
+    void next();
+    void previous();
+    byte enter();
+    void back();
+    byte selectedId();
+
+    // Menu State
+    const NHD_OLED_MenuList *list = 0;
+    byte selected = 0;
+    byte top = 0;
+  private:
+    void moveTo(const NHD_OLED_MenuList *newList, byte newSelected);
+    void update(const NHD_OLED_MenuList *oldList, byte oldTop,
+                byte oldSelected, byte all);
+    const char *label(const NHD_OLED_MenuList *from, byte item);
+    byte length(const char *text, byte limit);
+    char cell(const char *text, byte len, byte marked, byte column);
+
+    NHD_OLED *oled = 0;
+    byte firstRow = 0;
+    byte rows = 0;
+};
+
+#endif
+
+
+
+/*
+ * End of file!
+ */
\ No newline at end of file
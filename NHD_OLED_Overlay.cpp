@@ -0,0 +1,208 @@
+/*
+ * Newhaven Display Slim OLED Driver
+ * ---------------------------------
+ * 
+ * Overlays
+ * --------
+ * 
+ * NHD_OLED_Overlay is a rectangular window - a message box, say - that an
+ * NHD_OLED_Frame draws over its own content. The frame keeps its content
+ * underneath, so showing, changing or hiding an overlay only costs the
+ * cells it covers: on hide, the frame puts back what was there before
+ * without the application redrawing anything.
+ * 
+ * Overlays stack, with the most recently shown one on top.
+ * 
+ * 
+ * Software License Agreement (BSD License)
+ * 
+ * Copyright (c) 2015-2017 by Newhaven Display International, Inc.
+ * Copyright (c) 2017-2018 by Tom Honaker.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF 
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+
+
+#include "Arduino.h"
+#include "NHD_OLED_Overlay.h"
+
+
+
+// NHD_OLED_Overlay::begin
+//
+// Sets the overlay's storage, position and size, and fills it with spaces.
+// Show it with NHD_OLED_Frame::show().
+//
+// Parameters:
+//   cells: buffer for the overlay's content, at least rows * columns
+//          characters. It must stay valid as long as the overlay is used.
+//   row, column: frame position of the overlay's top-left cell.
+//   rows, columns: size of the overlay, up to the size of a frame.
+//
+void NHD_OLED_Overlay::begin(char *cells, byte row, byte column, byte rows,
+                             byte columns) {
+  this->cells = cells;
+  ROW = row;
+  COLUMN = column;
+
+  if (cells == 0) {
+    rows = 0;
+    columns = 0;
+  }
+
+  DISP_ROWS = rows;
+  if (DISP_ROWS > NHD_OLED_FRAME_ROWS)
+    DISP_ROWS = NHD_OLED_FRAME_ROWS;
+
+  DISP_COLUMNS = columns;
+  if (DISP_COLUMNS > NHD_OLED_FRAME_COLUMNS)
+    DISP_COLUMNS = NHD_OLED_FRAME_COLUMNS;
+
+  textClear();
+}
+
+
+// NHD_OLED_Overlay::move
+//
+// Moves the overlay, keeping its content. Takes effect on the next flush().
+//
+// Parameters:
+//   row, column: frame position of the overlay's top-left cell.
+//
+void NHD_OLED_Overlay::move(byte row, byte column) {
+  ROW = row;
+  COLUMN = column;
+}
+
+
+// NHD_OLED_Overlay::textClear
+//
+// Fills the overlay with spaces.
+//
+void NHD_OLED_Overlay::textClear() {
+  if (cells != 0)
+    memset(cells, 0x20, DISP_ROWS * DISP_COLUMNS);
+  cursorRow = 0;
+  cursorColumn = 0;
+}
+
+
+// NHD_OLED_Overlay::cursorPos
+//
+// Moves the overlay's write position.
+//
+// Parameters:
+//   row: row/line number, counted from the top of the overlay.
+//   column: column number, counted from the left of the overlay.
+//
+void NHD_OLED_Overlay::cursorPos(byte row, byte column) {
+  cursorRow = row;
+  cursorColumn = column;
+}
+
+
+// NHD_OLED_Overlay::print
+//
+// Writes text into the overlay at the write position, which moves along
+// with the text. Text running past the overlay's right edge is dropped.
+//
+// Parameters:
+//   text: text to display. This should be a full string if a length is
+//         provided.
+//   len: length of text to print, in characters.
+//
+void NHD_OLED_Overlay::print(char *text, byte len) {
+  for (byte i = 0; i < len; i++)
+    print(text[i]);
+}
+
+
+// NHD_OLED_Overlay::print - OVERLOAD
+//
+// Writes a single character into the overlay at the write position.
+//
+// Parameters:
+//   text: text to display. This must be a single character.
+//
+void NHD_OLED_Overlay::print(char text) {
+  if ((cursorRow < DISP_ROWS) and (cursorColumn < DISP_COLUMNS))
+    cells[cursorRow * DISP_COLUMNS + cursorColumn] = text;
+
+  if (cursorColumn < 255)
+    cursorColumn++;
+}
+
+
+// NHD_OLED_Overlay::print - OVERLOAD
+//
+// Moves the write position, then writes text into the overlay.
+//
+// Parameters:
+//   text: text to display. This should be a full string.
+//   len: length of text to print, in characters.
+//   r: row/line number, counted from the top of the overlay.
+//   c: column number, counted from the left of the overlay.
+//
+void NHD_OLED_Overlay::print(char *text, byte len, byte r, byte c) {
+  cursorPos(r, c);
+  print(text, len);
+}
+
+
+// NHD_OLED_Overlay::print - OVERLOAD
+//
+// Moves the write position, then writes a single character into the
+// overlay.
+//
+// Parameters:
+//   text: text to display. This must be a single character.
+//   r: row/line number, counted from the top of the overlay.
+//   c: column number, counted from the left of the overlay.
+//
+void NHD_OLED_Overlay::print(char text, byte r, byte c) {
+  cursorPos(r, c);
+  print(text);
+}
+
+
+// NHD_OLED_Overlay::covers
+//
+// Checks whether the overlay covers a frame cell.
+//
+// Parameters:
+//   r, c: frame cell to check.
+//
+byte NHD_OLED_Overlay::covers(byte r, byte c) {
+  return (r >= ROW) and (r - ROW < DISP_ROWS) and
+         (c >= COLUMN) and (c - COLUMN < DISP_COLUMNS);
+}
+
+
+
+/*
+ * End of file!
+ */
\ No newline at end of file
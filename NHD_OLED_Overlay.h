@@ -0,0 +1,93 @@
+/*
+ * Newhaven Display Slim OLED Driver
+ * ---------------------------------
+ * 
+ * Overlays
+ * --------
+ * 
+ * NHD_OLED_Overlay is a rectangular window - a message box, say - that an
+ * NHD_OLED_Frame draws over its own content. The frame keeps its content
+ * underneath, so showing, changing or hiding an overlay only costs the
+ * cells it covers: on hide, the frame puts back what was there before
+ * without the application redrawing anything.
+ * 
+ * Overlays stack, with the most recently shown one on top. Each overlay's
+ * cells are stored in a buffer the application provides, rows * columns
+ * characters, so a small box only costs what it holds.
+ * 
+ * 
+ * Software License Agreement (BSD License)
+ * 
+ * Copyright (c) 2015-2017 by Newhaven Display International, Inc.
+ * Copyright (c) 2017-2018 by Tom Honaker.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF 
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+
+
+#ifndef NHD_OLED_OVERLAY_H
+#define NHD_OLED_OVERLAY_H
+
+#include "Arduino.h"
+#include "NHD_OLED_Frame.h"
+
+class NHD_OLED_Overlay
+{
+  public:
+    void begin(char *cells, byte row, byte column, byte rows, byte columns);
+    void move(byte row, byte column);
+    void textClear();
+    void cursorPos(byte row, byte column);
+    void print(char *text, byte len);
+    void print(char text);
+    void print(char *text, byte len, byte r, byte c);
+    void print(char text, byte r, byte c);
+    byte covers(byte r, byte c);
+
+    // Overlay Position and Size - the position is in frame rows/columns.
+    byte ROW = 0;
+    byte COLUMN = 0;
+    byte DISP_ROWS = 0;
+    byte DISP_COLUMNS = 0;
+  private:
+    friend class NHD_OLED_Frame;
+
+    NHD_OLED_Overlay *next = 0;
+    byte cursorRow = 0;
+    byte cursorColumn = 0;
+
+    // Overlay content, DISP_ROWS rows of DISP_COLUMNS characters.
+    char *cells = 0;
+};
+
+#endif
+
+
+
+/*
+ * End of file!
+ */
\ No newline at end of file
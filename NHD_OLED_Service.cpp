@@ -0,0 +1,289 @@
+/*
+ * Newhaven Display Slim OLED Driver
+ * ---------------------------------
+ * 
+ * Display Service
+ * ---------------
+ * 
+ * NHD_OLED_Service lets several tasks or threads share one display. The
+ * driver isn't reentrant - two print() calls running at once interleave
+ * their bits mid-frame - so instead producers post small, fixed-size draw
+ * commands into a bounded lock-free queue, and a single owner task drains
+ * the queue into an NHD_OLED_Frame and flushes it. Commands aimed at the
+ * same cells are coalesced by the frame, so only the final contents go out.
+ * 
+ * Posting never blocks or takes a lock: a producer claims a queue slot with
+ * one compare-and-swap, and gives up straight away if the queue is full.
+ * 
+ * Needs std::atomic, so it's only built for cores with a C++11 standard
+ * library - ESP32, ARM and the host tools. It's left out of AVR builds.
+ * 
+ * 
+ * Software License Agreement (BSD License)
+ * 
+ * Copyright (c) 2015-2017 by Newhaven Display International, Inc.
+ * Copyright (c) 2017-2018 by Tom Honaker.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF 
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+
+
+// The Arduino builder compiles every library source, so AVR builds skip
+// this one rather than tripping the header's #error.
+#if !defined(__AVR__)
+
+#include "Arduino.h"
+#include "NHD_OLED_Service.h"
+
+
+
+// NHD_OLED_Service::begin
+//
+// Attaches the service to a frame and empties the queue. Call this before
+// any producer starts posting.
+//
+// Parameters:
+//   frame: frame to draw into. Its begin() must already have been called,
+//          and only the owner task may touch it from now on.
+//
+void NHD_OLED_Service::begin(NHD_OLED_Frame &frame) {
+  this->frame = &frame;
+
+  for (unsigned long i = 0; i < NHD_OLED_SERVICE_QUEUE; i++)
+    slots[i].sequence.store(i, std::memory_order_relaxed);
+
+  head.store(0, std::memory_order_relaxed);
+  tail = 0;
+  dropped.store(0, std::memory_order_release);
+}
+
+
+// NHD_OLED_Service::print
+//
+// Queues text to be printed at a position. Text longer than a draw command
+// holds is cut short.
+//
+// Parameters:
+//   text: text to display.
+//   len: length of text to print, in characters.
+//   r: row/line number (0-1/2/3).
+//   c: column number (0-16/20).
+//
+// Returns non-zero if the command was queued, zero if the queue was full.
+//
+byte NHD_OLED_Service::print(const char *text, byte len, byte r, byte c) {
+  NHD_OLED_Draw draw;
+
+  if (len > NHD_OLED_SERVICE_TEXT)
+    len = NHD_OLED_SERVICE_TEXT;
+
+  draw.kind = NHD_OLED_DRAW_TEXT;
+  draw.row = r;
+  draw.column = c;
+  draw.len = len;
+  memcpy(draw.text, text, len);
+
+  return post(draw);
+}
+
+
+// NHD_OLED_Service::print - OVERLOAD
+//
+// Queues a single character to be printed at a position.
+//
+// Parameters:
+//   text: text to display. This must be a single character.
+//   r: row/line number (0-1/2/3).
+//   c: column number (0-16/20).
+//
+// Returns non-zero if the command was queued, zero if the queue was full.
+//
+byte NHD_OLED_Service::print(char text, byte r, byte c) {
+  return print(&text, 1, r, c);
+}
+
+
+// NHD_OLED_Service::textClear
+//
+// Queues a clear of the whole display.
+//
+// Returns non-zero if the command was queued, zero if the queue was full.
+//
+byte NHD_OLED_Service::textClear() {
+  NHD_OLED_Draw draw;
+
+  draw.kind = NHD_OLED_DRAW_CLEAR;
+  draw.row = 0;
+  draw.column = 0;
+  draw.len = 0;
+
+  return post(draw);
+}
+
+
+// NHD_OLED_Service::textClearRow
+//
+// Queues a clear of one row/line.
+//
+// Parameters:
+//   rowNumber: row/line number to clear (zero-indexed, where 0 is topmost).
+//
+// Returns non-zero if the command was queued, zero if the queue was full.
+//
+byte NHD_OLED_Service::textClearRow(byte rowNumber) {
+  NHD_OLED_Draw draw;
+
+  draw.kind = NHD_OLED_DRAW_CLEAR_ROW;
+  draw.row = rowNumber;
+  draw.column = 0;
+  draw.len = 0;
+
+  return post(draw);
+}
+
+
+// NHD_OLED_Service::post
+//
+// Claims the next free slot with a compare-and-swap on the head position,
+// copies the command in, then hands the slot to the owner by moving its
+// sequence number on.
+//
+// Parameters:
+//   draw: command to queue.
+//
+// Returns non-zero if the command was queued, zero if the queue was full.
+//
+byte NHD_OLED_Service::post(const NHD_OLED_Draw &draw) {
+  unsigned long position = head.load(std::memory_order_relaxed);
+  unsigned long sequence;
+  long difference;
+  Slot *slot;
+
+  for (;;) {
+    slot = &slots[position & (NHD_OLED_SERVICE_QUEUE - 1)];
+    sequence = slot->sequence.load(std::memory_order_acquire);
+    difference = (long)(sequence - position);
+
+    if (difference == 0) {
+      // Free - try to claim it. On failure position is reloaded.
+      if (head.compare_exchange_weak(position, position + 1,
+                                     std::memory_order_relaxed))
+        break;
+    }
+    else if (difference < 0) {
+      // Still holding a command from a lap ago - the queue is full.
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return 0;
+    }
+    else {
+      // Another producer got here first.
+      position = head.load(std::memory_order_relaxed);
+    }
+  }
+
+  slot->draw = draw;
+  slot->sequence.store(position + 1, std::memory_order_release);
+
+  return 1;
+}
+
+
+// NHD_OLED_Service::drain
+//
+// Applies queued commands to the frame, in the order they were queued.
+// Nothing is sent to the display. At most one queue's worth is applied per
+// call, so producers that keep posting can't hold the owner here forever;
+// anything left is picked up by the next call.
+//
+// Returns non-zero if any commands were applied.
+//
+byte NHD_OLED_Service::drain() {
+  byte applied = 0;
+  Slot *slot;
+
+  for (unsigned int i = 0; i < NHD_OLED_SERVICE_QUEUE; i++) {
+    slot = &slots[tail & (NHD_OLED_SERVICE_QUEUE - 1)];
+    if (slot->sequence.load(std::memory_order_acquire) != tail + 1)
+      break;
+
+    switch (slot->draw.kind) {
+      case NHD_OLED_DRAW_TEXT:
+        frame->print(slot->draw.text, slot->draw.len, slot->draw.row,
+                     slot->draw.column);
+        break;
+      case NHD_OLED_DRAW_CLEAR:
+        frame->textClear();
+        break;
+      case NHD_OLED_DRAW_CLEAR_ROW:
+        frame->textClearRow(slot->draw.row);
+        break;
+    }
+
+    // Free the slot for the producers' next lap.
+    slot->sequence.store(tail + NHD_OLED_SERVICE_QUEUE,
+                         std::memory_order_release);
+    tail++;
+    applied = 1;
+  }
+
+  return applied;
+}
+
+
+// NHD_OLED_Service::service
+//
+// Drains the queue and brings the display up to date. Call this regularly
+// from the owner task.
+//
+void NHD_OLED_Service::service() {
+  drain();
+  frame->flush();
+}
+
+
+// NHD_OLED_Service::service - OVERLOAD
+//
+// Drains the queue, then sends as much of the update as fits in a time
+// budget. See NHD_OLED_Frame::flush().
+//
+// Parameters:
+//   maxMicros: time budget, in microseconds.
+//
+// Returns the number of cells still waiting to be sent.
+//
+unsigned int NHD_OLED_Service::service(unsigned long maxMicros) {
+  drain();
+  return frame->flush(maxMicros);
+}
+
+#endif
+
+
+
+/*
+ * End of file!
+ */
\ No newline at end of file
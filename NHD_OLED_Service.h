@@ -0,0 +1,127 @@
+/*
+ * Newhaven Display Slim OLED Driver
+ * ---------------------------------
+ * 
+ * Display Service
+ * ---------------
+ * 
+ * NHD_OLED_Service lets several tasks or threads share one display. The
+ * driver isn't reentrant - two print() calls running at once interleave
+ * their bits mid-frame - so instead producers post small, fixed-size draw
+ * commands into a bounded lock-free queue, and a single owner task drains
+ * the queue into an NHD_OLED_Frame and flushes it. Commands aimed at the
+ * same cells are coalesced by the frame, so only the final contents go out.
+ * 
+ * Posting never blocks or takes a lock: a producer claims a queue slot with
+ * one compare-and-swap, and gives up straight away if the queue is full.
+ * 
+ * Needs std::atomic, so it's only available on cores with a C++11 standard
+ * library - ESP32, ARM and the host tools. Including it in an AVR sketch
+ * stops the build with an error saying so.
+ * 
+ * 
+ * Software License Agreement (BSD License)
+ * 
+ * Copyright (c) 2015-2017 by Newhaven Display International, Inc.
+ * Copyright (c) 2017-2018 by Tom Honaker.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF 
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+
+
+#ifndef NHD_OLED_SERVICE_H
+#define NHD_OLED_SERVICE_H
+
+#if defined(__AVR__)
+#error "NHD_OLED_Service needs <atomic>; not available on AVR"
+#endif
+
+#include <atomic>
+#include "Arduino.h"
+#include "NHD_OLED_Frame.h"
+
+// Queue length - must be a power of two.
+#define NHD_OLED_SERVICE_QUEUE 32
+
+// Longest text a single draw command carries.
+#define NHD_OLED_SERVICE_TEXT 20
+
+// Draw command kinds.
+#define NHD_OLED_DRAW_TEXT      0  // Print text at a position
+#define NHD_OLED_DRAW_CLEAR     1  // Blank the whole display
+#define NHD_OLED_DRAW_CLEAR_ROW 2  // Blank one row/line
+
+// A queued draw command.
+struct NHD_OLED_Draw {
+  byte kind;
+  byte row;
+  byte column;
+  byte len;
+  char text[NHD_OLED_SERVICE_TEXT];
+};
+
+class NHD_OLED_Service
+{
+  public:
+    void begin(NHD_OLED_Frame &frame);
+
+    // Producer side - safe to call from any task or thread.
+    byte print(const char *text, byte len, byte r, byte c);
+    byte print(char text, byte r, byte c);
+    byte textClear();
+    byte textClearRow(byte rowNumber);
+
+    // Owner side - call from one task only.
+    byte drain();
+    void service();
+    unsigned int service(unsigned long maxMicros);
+
+    // Commands turned away because the queue was full.
+    std::atomic<unsigned long> dropped;
+  private:
+    byte post(const NHD_OLED_Draw &draw);
+
+    // A queue slot. Its sequence number says whose turn it is: equal to the
+    // position when free for a producer, one more once filled.
+    struct Slot {
+      std::atomic<unsigned long> sequence;
+      NHD_OLED_Draw draw;
+    };
+
+    NHD_OLED_Frame *frame = 0;
+    Slot slots[NHD_OLED_SERVICE_QUEUE];
+    std::atomic<unsigned long> head;
+    unsigned long tail = 0;
+};
+
+#endif
+
+
+
+/*
+ * End of file!
+ */
\ No newline at end of file
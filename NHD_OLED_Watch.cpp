@@ -0,0 +1,343 @@
+/*
+ * Newhaven Display Slim OLED Driver
+ * ---------------------------------
+ * 
+ * Watch Fields
+ * ------------
+ * 
+ * NHD_OLED_Field binds an application variable - an int, a fixed-point
+ * value held in an int, or an enum shown as a PROGMEM label - to a spot on
+ * the display. NHD_OLED_Watch keeps a list of fields and refreshes them
+ * from loop(), each no more often than its own interval allows.
+ * 
+ * A field only remembers the value it last showed. When the variable
+ * changes, the old and new values are formatted side by side on the stack
+ * and only the characters that differ are sent - so a counter going from
+ * 1234 to 1235 costs one set-address command and one data byte.
+ * 
+ * 
+ * Software License Agreement (BSD License)
+ * 
+ * Copyright (c) 2015-2017 by Newhaven Display International, Inc.
+ * Copyright (c) 2017-2018 by Tom Honaker.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF 
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+
+
+#include "Arduino.h"
+#include "NHD_OLED_Watch.h"
+
+
+
+// NHD_OLED_Field::bindInt
+//
+// Shows an int as a right-justified decimal number.
+//
+// Parameters:
+//   value: variable to show. It must stay in scope while the field is
+//          being watched.
+//   row, column: position of the field's leftmost character.
+//   width: field width, in characters. Numbers too wide for it are shown
+//          as a row of #s.
+//
+void NHD_OLED_Field::bindInt(const int *value, byte row, byte column,
+                             byte width) {
+  bind(NHD_OLED_FIELD_INT, value, row, column, width);
+}
+
+
+// NHD_OLED_Field::bindFixed
+//
+// Shows a fixed-point value held in an int - for example, 2150 with 2
+// decimals shows as 21.50.
+//
+// Parameters:
+//   value: variable to show, scaled up by 10 to the power of decimals.
+//   decimals: digits after the decimal point.
+//   row, column: position of the field's leftmost character.
+//   width: field width, in characters, including the point and any sign.
+//
+void NHD_OLED_Field::bindFixed(const int *value, byte decimals, byte row,
+                               byte column, byte width) {
+  bind(NHD_OLED_FIELD_FIXED, value, row, column, width);
+  this->decimals = decimals;
+}
+
+
+// NHD_OLED_Field::bindLabel
+//
+// Shows a byte-sized enum as one of a table of PROGMEM labels.
+//
+// Parameters:
+//   value: variable to show.
+//   labels: PROGMEM table of PROGMEM strings, one per value.
+//   count: number of labels. Values past the end show as ?.
+//   row, column: position of the field's leftmost character.
+//   width: field width, in characters. Longer labels are cut short.
+//
+void NHD_OLED_Field::bindLabel(const byte *value, const char * const *labels,
+                               byte count, byte row, byte column,
+                               byte width) {
+  bind(NHD_OLED_FIELD_LABEL, value, row, column, width);
+  this->labels = labels;
+  this->count = count;
+}
+
+
+// NHD_OLED_Field::bind
+//
+// Common setup for the bind functions. The field is drawn in full on the
+// next refresh.
+//
+void NHD_OLED_Field::bind(byte format, const void *value, byte row,
+                          byte column, byte width) {
+  this->format = format;
+  this->value = value;
+  ROW = row;
+  COLUMN = column;
+  WIDTH = (width > NHD_OLED_FIELD_WIDTH) ? NHD_OLED_FIELD_WIDTH : width;
+  decimals = 0;
+  labels = 0;
+  count = 0;
+  valid = 0;
+}
+
+
+// NHD_OLED_Field::current
+//
+// Returns the bound variable's value.
+//
+int NHD_OLED_Field::current() {
+  if (format == NHD_OLED_FIELD_LABEL)
+    return *(const byte *)value;
+
+  return *(const int *)value;
+}
+
+
+// NHD_OLED_Field::render
+//
+// Formats a value the way the field shows it.
+//
+// Parameters:
+//   value: value to format.
+//   out: receives exactly WIDTH characters, with no terminator.
+//
+void NHD_OLED_Field::render(int value, char *out) {
+  // Room for one digit and a decimal point past the field width, which is
+  // how an overflow shows, plus the sign.
+  char digits[NHD_OLED_FIELD_WIDTH + 3];
+  unsigned int magnitude;
+  const char *text;
+  byte len = 0, i;
+
+  if (format == NHD_OLED_FIELD_LABEL) {
+    text = 0;
+    if ((unsigned int)value < count)
+      text = (const char *)pgm_read_ptr(&labels[value]);
+
+    for (i = 0; i < WIDTH; i++) {
+      out[i] = (text != 0) ? pgm_read_byte(text + i) : 0x20;
+      if (out[i] == 0) {
+        text = 0;
+        out[i] = 0x20;
+      }
+    }
+
+    if (((unsigned int)value >= count) and (WIDTH > 0))
+      out[0] = '?';
+    return;
+  }
+
+  // Digits go in backwards, least significant first.
+  magnitude = (value < 0) ? 0U - (unsigned int)value : (unsigned int)value;
+  do {
+    if ((format == NHD_OLED_FIELD_FIXED) and (decimals > 0) and
+        (len == decimals))
+      digits[len++] = '.';
+    digits[len++] = '0' + magnitude % 10;
+    magnitude /= 10;
+  } while (((magnitude > 0) or
+            ((format == NHD_OLED_FIELD_FIXED) and (len <= decimals))) and
+           (len <= NHD_OLED_FIELD_WIDTH));
+
+  if (value < 0)
+    digits[len++] = '-';
+
+  if (len > WIDTH) {
+    memset(out, '#', WIDTH);
+    return;
+  }
+
+  memset(out, 0x20, WIDTH - len);
+  for (i = 0; i < len; i++)
+    out[WIDTH - 1 - i] = digits[i];
+}
+
+
+
+// NHD_OLED_Watch::begin
+//
+// Attaches the watch list to a display.
+//
+// Parameters:
+//   display: display to draw on. begin() must already have been called.
+//
+void NHD_OLED_Watch::begin(NHD_OLED &display) {
+  oled = &display;
+  fields = 0;
+}
+
+
+// NHD_OLED_Watch::add
+//
+// Starts watching a field. It's drawn in full on the next refresh().
+//
+// Parameters:
+//   field: field to watch. It must stay in scope while it's watched.
+//   intervalMs: shortest time between refreshes of this field, in
+//               milliseconds. 0 refreshes it on every call.
+//
+void NHD_OLED_Watch::add(NHD_OLED_Field &field, unsigned int intervalMs) {
+  remove(field);
+
+  field.intervalMs = intervalMs;
+  field.valid = 0;
+  field.next = fields;
+  fields = &field;
+}
+
+
+// NHD_OLED_Watch::remove
+//
+// Stops watching a field. What it last showed stays on the display.
+//
+// Parameters:
+//   field: field to stop watching.
+//
+void NHD_OLED_Watch::remove(NHD_OLED_Field &field) {
+  NHD_OLED_Field **link = &fields;
+
+  while ((*link != 0) and (*link != &field))
+    link = &(*link)->next;
+
+  if (*link != 0)
+    *link = field.next;
+
+  field.next = 0;
+}
+
+
+// NHD_OLED_Watch::refresh
+//
+// Checks every field that's due and sends the characters that changed.
+// Call this from loop().
+//
+// Returns non-zero if anything was sent.
+//
+byte NHD_OLED_Watch::refresh() {
+  unsigned long now = millis();
+  byte sent = 0;
+  int value;
+
+  oled->batchBegin();
+
+  for (NHD_OLED_Field *f = fields; f != 0; f = f->next) {
+    if (f->valid and (now - f->lastMs < f->intervalMs))
+      continue;
+
+    f->lastMs = now;
+    value = f->current();
+    if (f->valid and (value == f->shown))
+      continue;
+
+    update(*f, value);
+    sent = 1;
+  }
+
+  oled->batchEnd();
+
+  return sent;
+}
+
+
+// NHD_OLED_Watch::redraw
+//
+// Draws every field in full on the next refresh(), for when something else
+// has drawn over them.
+//
+void NHD_OLED_Watch::redraw() {
+  for (NHD_OLED_Field *f = fields; f != 0; f = f->next)
+    f->valid = 0;
+}
+
+
+// NHD_OLED_Watch::update
+//
+// Formats the field's old and new values and sends the runs of characters
+// that differ, merging runs as NHD_OLED::runEnd() does.
+//
+// Parameters:
+//   field: field to update.
+//   value: value to show.
+//
+void NHD_OLED_Watch::update(NHD_OLED_Field &field, int value) {
+  char before[NHD_OLED_FIELD_WIDTH], after[NHD_OLED_FIELD_WIDTH];
+  byte start, end, i;
+
+  field.render(value, after);
+  if (field.valid)
+    field.render(field.shown, before);
+  else
+    memset(before, 0, sizeof(before));
+
+  field.shown = value;
+  field.valid = 1;
+
+  start = 0;
+  while (start < field.WIDTH) {
+    if (before[start] == after[start]) {
+      start++;
+      continue;
+    }
+
+    end = oled->runEnd(before, after, start, field.WIDTH);
+
+    oled->cursorPos(field.ROW, field.COLUMN + start);
+    for (i = start; i < end; i++)
+      oled->sendData(after[i]);
+
+    start = end;
+  }
+}
+
+
+
+/*
+ * End of file!
+ */
\ No newline at end of file
@@ -0,0 +1,122 @@
+/*
+ * Newhaven Display Slim OLED Driver
+ * ---------------------------------
+ * 
+ * Watch Fields
+ * ------------
+ * 
+ * NHD_OLED_Field binds an application variable - an int, a fixed-point
+ * value held in an int, or an enum shown as a PROGMEM label - to a spot on
+ * the display. NHD_OLED_Watch keeps a list of fields and refreshes them
+ * from loop(), each no more often than its own interval allows.
+ * 
+ * A field only remembers the value it last showed. When the variable
+ * changes, the old and new values are formatted side by side on the stack
+ * and only the characters that differ are sent - so a counter going from
+ * 1234 to 1235 costs one set-address command and one data byte.
+ * 
+ * 
+ * Software License Agreement (BSD License)
+ * 
+ * Copyright (c) 2015-2017 by Newhaven Display International, Inc.
+ * Copyright (c) 2017-2018 by Tom Honaker.
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF 
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ */
+
+
+
+#ifndef NHD_OLED_WATCH_H
+#define NHD_OLED_WATCH_H
+
+#include "Arduino.h"
+#include "NHD_OLED_Driver.h"
+
+// Widest field, in characters.
+#define NHD_OLED_FIELD_WIDTH 20
+
+// Field formats.
+#define NHD_OLED_FIELD_INT   0  // Right-justified decimal
+#define NHD_OLED_FIELD_FIXED 1  // Right-justified, with a decimal point
+#define NHD_OLED_FIELD_LABEL 2  // Left-justified PROGMEM label
+
+class NHD_OLED_Field
+{
+  public:
+    void bindInt(const int *value, byte row, byte column, byte width);
+    void bindFixed(const int *value, byte decimals, byte row, byte column,
+                   byte width);
+    void bindLabel(const byte *value, const char * const *labels, byte count,
+                   byte row, byte column, byte width);
+
+    // Field Position and Size
+    byte ROW = 0;
+    byte COLUMN = 0;
+    byte WIDTH = 0;
+  private:
+    friend class NHD_OLED_Watch;
+
+    void bind(byte format, const void *value, byte row, byte column,
+              byte width);
+    int current();
+    void render(int value, char *out);
+
+    NHD_OLED_Field *next = 0;
+    byte format = NHD_OLED_FIELD_INT;
+    const void *value = 0;
+    byte decimals = 0;
+    const char * const *labels = 0;
+    byte count = 0;
+
+    // What's on the display, and when it was last refreshed.
+    int shown = 0;
+    byte valid = 0;
+    unsigned int intervalMs = 0;
+    unsigned long lastMs = 0;
+};
+
+class NHD_OLED_Watch
+{
+  public:
+    void begin(NHD_OLED &display);
+    void add(NHD_OLED_Field &field, unsigned int intervalMs = 0);
+    void remove(NHD_OLED_Field &field);
+    byte refresh();
+    void redraw();
+  private:
+    void update(NHD_OLED_Field &field, int value);
+
+    NHD_OLED *oled = 0;
+    NHD_OLED_Field *fields = 0;
+};
+
+#endif
+
+
+
+/*
+ * End of file!
+ */
\ No newline at end of file
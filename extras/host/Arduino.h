@@ -0,0 +1,64 @@
+/*
+ * Newhaven Display Slim OLED Driver - Host Build Arduino Stand-In
+ * ---------------------------------------------------------------
+ *
+ * A minimal replacement for the Arduino core header, just big enough to
+ * compile the driver on a desktop machine. Pin writes, delays and timers
+ * are routed into the simulated GPIO layer in HostGPIO.cpp, which keeps a
+ * simulated clock and a log of every pin transition.
+ *
+ * This file is only used by the host tools in extras/host - it is never
+ * seen by a real Arduino build.
+ *
+ * Software License Agreement (BSD License) - see LICENSE.txt.
+ *
+ */
+
+
+
+#ifndef NHD_OLED_HOST_ARDUINO_H
+#define NHD_OLED_HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH   1
+#define LOW    0
+#define INPUT  0
+#define OUTPUT 1
+
+// Program memory is ordinary memory on the host. Words are 16 bits, as on
+// AVR; pointers stored in program memory are read with pgm_read_ptr().
+// Addresses and words pass through uintptr_t, so the driver's string-table
+// printers - which carry addresses in an int - compile as they are. They
+// can't work here, though: an int can't hold a desktop pointer.
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) \
+  ((uintptr_t)*(const uint16_t *)(uintptr_t)(addr))
+#define pgm_read_ptr(addr) (*(void * const *)(addr))
+#define strcpy_P(dest, src) strcpy((dest), (src))
+
+void pinMode(byte pin, byte mode);
+void digitalWrite(byte pin, byte value);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+unsigned long micros();
+unsigned long millis();
+
+// Charges the simulated cost of the driver's hold loop to the clock, in
+// place of the driver's own busy-wait.
+void hostSpin(unsigned int loops);
+#define NHD_OLED_BUS_HOLD(loops) hostSpin(loops)
+
+#endif
+
+
+
+/*
+ * End of file!
+ */
@@ -0,0 +1,439 @@
+/*
+ * Newhaven Display Slim OLED Driver - Simulated GPIO Layer
+ * --------------------------------------------------------
+ *
+ * See HostGPIO.h for an overview.
+ *
+ * Software License Agreement (BSD License) - see LICENSE.txt.
+ *
+ */
+
+
+
+#include <algorithm>
+#include <string>
+#include "HostGPIO.h"
+
+
+
+HostGPIO hostGPIO;
+
+
+
+// Arduino API stand-ins
+//
+// These route the driver's pin and timing calls into the simulator.
+//
+void pinMode(byte pin, byte mode) {
+  hostGPIO.mode(pin, mode);
+}
+
+void digitalWrite(byte pin, byte value) {
+  hostGPIO.write(pin, value);
+}
+
+void delay(unsigned long ms) {
+  hostGPIO.advance((unsigned long long)ms * 1000000ULL);
+}
+
+void delayMicroseconds(unsigned int us) {
+  hostGPIO.advance((unsigned long long)us * 1000ULL);
+}
+
+unsigned long micros() {
+  return (unsigned long)(hostGPIO.nowNs / 1000ULL);
+}
+
+unsigned long millis() {
+  return (unsigned long)(hostGPIO.nowNs / 1000000ULL);
+}
+
+void hostSpin(unsigned int loops) {
+  hostGPIO.advance((unsigned long long)loops * hostGPIO.holdNs);
+}
+
+
+
+// HostGPIO::HostGPIO
+//
+// Sets up the simulator with all pins low and the clock at zero.
+//
+HostGPIO::HostGPIO() {
+  writeNs = 3500;
+  holdNs = 375;
+  reset();
+}
+
+
+// HostGPIO::reset
+//
+// Returns every pin to an unused low state, zeroes the clock and empties the
+// transition log.
+//
+void HostGPIO::reset() {
+  nowNs = 0;
+  memset(level, 0, sizeof(level));
+  memset(used, 0, sizeof(used));
+  clearLog();
+}
+
+
+// HostGPIO::clearLog
+//
+// Empties the transition log without touching pin state or the clock. Call
+// this after setup to capture only the API calls of interest.
+//
+void HostGPIO::clearLog() {
+  edges.clear();
+  memcpy(logLevel, level, sizeof(level));
+  logStartNs = nowNs;
+}
+
+
+// HostGPIO::advance
+//
+// Moves the simulated clock forward.
+//
+// Parameters:
+//   ns: time to advance, in nanoseconds.
+//
+void HostGPIO::advance(unsigned long long ns) {
+  nowNs += ns;
+}
+
+
+// HostGPIO::mode
+//
+// Marks a pin as in use so it shows up in the VCD output.
+//
+// Parameters:
+//   pin: pin number.
+//   mode: pin mode (ignored - all pins are treated as outputs).
+//
+void HostGPIO::mode(byte pin, byte) {
+  if (pin >= HOST_GPIO_PINS)
+    return;
+
+  if (!used[pin]) {
+    used[pin] = 1;
+    logLevel[pin] = level[pin];
+  }
+}
+
+
+// HostGPIO::write
+//
+// Charges the cost of a digitalWrite() to the clock, then logs a transition
+// if the pin's level changed. As with the real thing, the pin changes state
+// at the end of the call.
+//
+// Parameters:
+//   pin: pin number.
+//   value: new level - zero for low, non-zero for high.
+//
+void HostGPIO::write(byte pin, byte value) {
+  advance(writeNs);
+
+  if (pin >= HOST_GPIO_PINS)
+    return;
+
+  value = (value != 0);
+  used[pin] = 1;
+  if (level[pin] == value)
+    return;
+
+  level[pin] = value;
+
+  HostEdge edge = {nowNs, pin, value};
+  edges.push_back(edge);
+}
+
+
+// HostGPIO::decodeSPI
+//
+// Samples SDIN on every SCLK rising edge in the log and reassembles the bits
+// into the 24-bit frames produced by NHD_OLED::SPIBitBang(): a start byte
+// (five sync ones, R/W, RS, zero), then the low nibble of the payload LSB-
+// first, four zeroes, the high nibble LSB-first and four more zeroes. If the
+// sync bits don't line up the decoder slips one bit and tries again.
+//
+// Parameters:
+//   pinSCLK: pin used as SPI clock.
+//   pinSDIN: pin used as SPI data.
+//   frames: receives the decoded frames.
+//
+void HostGPIO::decodeSPI(byte pinSCLK, byte pinSDIN,
+                         std::vector<HostFrame> &frames) {
+  std::vector<byte> bits;
+  std::vector<unsigned long long> bitStart, bitEnd;
+  byte sclk = logLevel[pinSCLK];
+  byte sdin = logLevel[pinSDIN];
+  unsigned long long fallNs = logStartNs;
+  size_t i, b;
+
+  frames.clear();
+
+  // Pull the bit stream out of the transition log.
+  for (i = 0; i < edges.size(); i++) {
+    const HostEdge &edge = edges[i];
+
+    if (edge.pin == pinSDIN)
+      sdin = edge.value;
+
+    if (edge.pin != pinSCLK)
+      continue;
+
+    sclk = edge.value;
+    if (sclk == LOW) {
+      fallNs = edge.ns;
+    }
+    else {
+      bits.push_back(sdin);
+      bitStart.push_back(fallNs);
+      bitEnd.push_back(edge.ns);
+    }
+  }
+
+  // Chop the bit stream into frames.
+  i = 0;
+  while (i + 24 <= bits.size()) {
+    if (!(bits[i] && bits[i + 1] && bits[i + 2] && bits[i + 3] &&
+          bits[i + 4]) || bits[i + 7]) {
+      i++;
+      continue;
+    }
+
+    HostFrame frame;
+    frame.startNs = bitStart[i];
+    frame.endNs = bitEnd[i + 23];
+    frame.start = 0;
+    frame.payload = 0;
+    frame.valid = 1;
+
+    for (b = 0; b < 8; b++)
+      frame.start = (frame.start << 1) | bits[i + b];
+
+    for (b = 0; b < 4; b++) {
+      frame.payload |= bits[i + 8 + b] << b;
+      frame.payload |= bits[i + 16 + b] << (b + 4);
+      if (bits[i + 12 + b] || bits[i + 20 + b])
+        frame.valid = 0;
+    }
+
+    frame.isCommand = ((frame.start & 0x02) == 0);
+    frames.push_back(frame);
+    i += 24;
+  }
+}
+
+
+// HostGPIO::printFrames
+//
+// Writes one annotated line per decoded frame: start time, frame length, the
+// idle gap since the previous frame, the start byte and the payload.
+//
+// Parameters:
+//   out: stream to write to.
+//   frames: frames from decodeSPI().
+//
+void HostGPIO::printFrames(FILE *out, const std::vector<HostFrame> &frames) {
+  unsigned long long prevEnd = 0;
+
+  for (size_t i = 0; i < frames.size(); i++) {
+    const HostFrame &frame = frames[i];
+    double gap = (i == 0) ? 0.0 : (frame.startNs - prevEnd) / 1000.0;
+
+    fprintf(out, "%5u  t=%12.3fus  len=%8.3fus  gap=%10.3fus  start=0x%02X  "
+                 "%s 0x%02X",
+            (unsigned)i, (frame.startNs - logStartNs) / 1000.0,
+            (frame.endNs - frame.startNs) / 1000.0, gap, frame.start,
+            frame.isCommand ? "CMD " : "DATA", frame.payload);
+
+    if (!frame.isCommand && frame.payload >= 0x20 && frame.payload < 0x7F)
+      fprintf(out, " '%c'", frame.payload);
+    if (!frame.valid)
+      fprintf(out, "  [bad padding]");
+    fprintf(out, "\n");
+
+    prevEnd = frame.endNs;
+  }
+}
+
+
+// HostGPIO::printSummary
+//
+// Writes bus statistics for the decoded frames: frame counts, the time from
+// the first frame starting to the last one ending, how much of that time the
+// bus was actually carrying frames, and the idle gaps between frames.
+//
+// Parameters:
+//   out: stream to write to.
+//   frames: frames from decodeSPI().
+//
+void HostGPIO::printSummary(FILE *out, const std::vector<HostFrame> &frames) {
+  unsigned long long busy = 0, span, gap, gapMin = 0, gapMax = 0, gapSum = 0;
+  unsigned commands = 0;
+  size_t i;
+
+  if (frames.empty()) {
+    fprintf(out, "No frames decoded.\n");
+    return;
+  }
+
+  for (i = 0; i < frames.size(); i++) {
+    busy += frames[i].endNs - frames[i].startNs;
+    if (frames[i].isCommand)
+      commands++;
+
+    if (i == 0)
+      continue;
+
+    gap = frames[i].startNs - frames[i - 1].endNs;
+    gapSum += gap;
+    if (i == 1 || gap < gapMin)
+      gapMin = gap;
+    if (gap > gapMax)
+      gapMax = gap;
+  }
+
+  span = frames.back().endNs - frames.front().startNs;
+
+  fprintf(out, "Frames:           %u (%u command, %u data)\n",
+          (unsigned)frames.size(), commands,
+          (unsigned)frames.size() - commands);
+  fprintf(out, "Span:             %.3f us\n", span / 1000.0);
+  fprintf(out, "Bus busy:         %.3f us\n", busy / 1000.0);
+  fprintf(out, "Utilization:      %.1f %%\n",
+          span ? (100.0 * busy) / span : 100.0);
+  fprintf(out, "Avg frame:        %.3f us\n", busy / 1000.0 / frames.size());
+  if (frames.size() > 1)
+    fprintf(out, "Idle gap:         min %.3f us, avg %.3f us, max %.3f us\n",
+            gapMin / 1000.0, gapSum / 1000.0 / (frames.size() - 1),
+            gapMax / 1000.0);
+}
+
+
+// HostGPIO::writeVCD
+//
+// Writes the transition log as a VCD file for GTKWave. Alongside one wire per
+// pin used, three decoded signals are added: "frame" is high while a frame is
+// on the bus, "rs" is the frame's RS bit (high for data) and "payload" holds
+// the frame's byte from the start of the frame until the next one.
+//
+// Parameters:
+//   path: file to write.
+//   pinSCLK: pin used as SPI clock.
+//   pinSDIN: pin used as SPI data.
+//
+// Returns false if the file couldn't be written.
+//
+bool HostGPIO::writeVCD(const char *path, byte pinSCLK, byte pinSDIN) {
+  struct Event {
+    unsigned long long ns;
+    std::string text;
+    bool operator<(const Event &other) const { return ns < other.ns; }
+  };
+
+  std::vector<HostFrame> frames;
+  std::vector<Event> events;
+  char id[HOST_GPIO_PINS];
+  char idNext = '!';
+  char idFrame, idRS, idPayload;
+  char text[32];
+  unsigned long long lastNs;
+  size_t i;
+  int b;
+
+  FILE *out = fopen(path, "w");
+  if (out == NULL)
+    return false;
+
+  decodeSPI(pinSCLK, pinSDIN, frames);
+
+  fprintf(out, "$version NHD_OLED host GPIO simulator $end\n");
+  fprintf(out, "$timescale 1ns $end\n");
+  fprintf(out, "$scope module nhd_oled $end\n");
+
+  for (i = 0; i < HOST_GPIO_PINS; i++) {
+    if (!used[i])
+      continue;
+    id[i] = idNext++;
+    if (i == pinSCLK)
+      fprintf(out, "$var wire 1 %c sclk $end\n", id[i]);
+    else if (i == pinSDIN)
+      fprintf(out, "$var wire 1 %c sdin $end\n", id[i]);
+    else
+      fprintf(out, "$var wire 1 %c pin%u $end\n", id[i], (unsigned)i);
+  }
+
+  idFrame = idNext++;
+  idRS = idNext++;
+  idPayload = idNext++;
+  fprintf(out, "$var wire 1 %c frame $end\n", idFrame);
+  fprintf(out, "$var wire 1 %c rs $end\n", idRS);
+  fprintf(out, "$var reg 8 %c payload $end\n", idPayload);
+  fprintf(out, "$upscope $end\n");
+  fprintf(out, "$enddefinitions $end\n");
+
+  // Initial values.
+  fprintf(out, "#0\n$dumpvars\n");
+  for (i = 0; i < HOST_GPIO_PINS; i++)
+    if (used[i])
+      fprintf(out, "%u%c\n", logLevel[i], id[i]);
+  fprintf(out, "0%c\nx%c\nbxxxxxxxx %c\n$end\n", idFrame, idRS, idPayload);
+
+  // Gather pin transitions and frame annotations, then sort them by time.
+  for (i = 0; i < edges.size(); i++) {
+    if (edges[i].pin >= HOST_GPIO_PINS || !used[edges[i].pin])
+      continue;
+    snprintf(text, sizeof(text), "%u%c\n", edges[i].value, id[edges[i].pin]);
+    Event event = {edges[i].ns, text};
+    events.push_back(event);
+  }
+
+  for (i = 0; i < frames.size(); i++) {
+    std::string start;
+
+    snprintf(text, sizeof(text), "1%c\n%u%c\n", idFrame,
+             frames[i].isCommand ? 0 : 1, idRS);
+    start = text;
+
+    start += 'b';
+    for (b = 7; b >= 0; b--)
+      start += frames[i].valid ? (char)('0' + ((frames[i].payload >> b) & 1))
+                               : 'x';
+    start += ' ';
+    start += idPayload;
+    start += '\n';
+
+    Event begin = {frames[i].startNs, start};
+    events.push_back(begin);
+
+    snprintf(text, sizeof(text), "0%c\n", idFrame);
+    Event end = {frames[i].endNs, text};
+    events.push_back(end);
+  }
+
+  std::stable_sort(events.begin(), events.end());
+
+  lastNs = 0;
+  for (i = 0; i < events.size(); i++) {
+    unsigned long long t = events[i].ns - logStartNs;
+
+    if (i == 0 || t != lastNs)
+      fprintf(out, "#%llu\n", t);
+    fputs(events[i].text.c_str(), out);
+    lastNs = t;
+  }
+
+  fprintf(out, "#%llu\n", nowNs - logStartNs);
+
+  fclose(out);
+  return true;
+}
+
+
+
+/*
+ * End of file!
+ */
@@ -0,0 +1,90 @@
+/*
+ * Newhaven Display Slim OLED Driver - Simulated GPIO Layer
+ * --------------------------------------------------------
+ *
+ * Host-side stand-in for digitalWrite()/pinMode()/delay() that records every
+ * pin transition against a simulated clock. The log can be written out as a
+ * VCD file for GTKWave, and the SPI decoder turns the SCLK/SDIN activity
+ * back into the 24-bit frames the driver sent, so bus timing can be studied
+ * for any API call without a logic analyzer on the bench.
+ *
+ * Simulated time only advances when the driver does something that costs
+ * time on real hardware: each digitalWrite() costs writeNs, each driver
+ * hold-loop iteration costs holdNs, and delay()/
+ * delayMicroseconds() advance the clock by the requested amount. The default
+ * cost is in the right ballpark for digitalWrite() on a 16MHz AVR.
+ *
+ * Software License Agreement (BSD License) - see LICENSE.txt.
+ *
+ */
+
+
+
+#ifndef NHD_OLED_HOST_GPIO_H
+#define NHD_OLED_HOST_GPIO_H
+
+#include <stdio.h>
+#include <vector>
+#include "Arduino.h"
+
+#define HOST_GPIO_PINS 64
+
+// A single recorded pin transition.
+struct HostEdge {
+  unsigned long long ns;
+  byte pin;
+  byte value;
+};
+
+// A single decoded SPI frame.
+struct HostFrame {
+  unsigned long long startNs;  // SCLK falling edge ahead of the first bit
+  unsigned long long endNs;    // SCLK rising edge of the 24th bit
+  byte start;                  // start byte (0xF8 = command, 0xFA = data)
+  byte payload;                // reassembled data/command byte
+  byte isCommand;              // non-zero if RS was low (command)
+  byte valid;                  // zero if the padding bits weren't zeroes
+};
+
+class HostGPIO {
+  public:
+    HostGPIO();
+
+    void reset();
+    void clearLog();
+    void advance(unsigned long long ns);
+    void mode(byte pin, byte mode);
+    void write(byte pin, byte value);
+
+    void decodeSPI(byte pinSCLK, byte pinSDIN, std::vector<HostFrame> &frames);
+    void printFrames(FILE *out, const std::vector<HostFrame> &frames);
+    void printSummary(FILE *out, const std::vector<HostFrame> &frames);
+    bool writeVCD(const char *path, byte pinSCLK, byte pinSDIN);
+
+    // Simulated cost of a single digitalWrite(), in nanoseconds.
+    unsigned long writeNs;
+
+    // Simulated cost of one iteration of the driver's hold loop.
+    unsigned long holdNs;
+
+    // Simulated time, in nanoseconds since reset().
+    unsigned long long nowNs;
+
+    // Pin state and transition log. The log starts at logStartNs with the
+    // pins at logLevel.
+    byte level[HOST_GPIO_PINS];
+    byte used[HOST_GPIO_PINS];
+    byte logLevel[HOST_GPIO_PINS];
+    unsigned long long logStartNs;
+    std::vector<HostEdge> edges;
+};
+
+extern HostGPIO hostGPIO;
+
+#endif
+
+
+
+/*
+ * End of file!
+ */
@@ -0,0 +1,153 @@
+/*
+ * Newhaven Display Slim OLED Driver - Host Build Wire Stand-In
+ * ------------------------------------------------------------
+ *
+ * See Wire.h for an overview.
+ *
+ * Software License Agreement (BSD License) - see LICENSE.txt.
+ *
+ */
+
+
+
+#include "Wire.h"
+#include "HostGPIO.h"
+
+
+
+TwoWire Wire;
+
+
+
+TwoWire::TwoWire() {
+  clockHz = 100000;
+  open = false;
+}
+
+void TwoWire::begin() {
+}
+
+void TwoWire::setClock(unsigned long clock) {
+  clockHz = clock;
+}
+
+void TwoWire::beginTransmission(byte address) {
+  current.address = address;
+  current.bytes.clear();
+  current.ns = hostGPIO.nowNs;
+  open = true;
+}
+
+size_t TwoWire::write(byte data) {
+  if (!open || current.bytes.size() >= BUFFER_LENGTH)
+    return 0;
+
+  current.bytes.push_back(data);
+  return 1;
+}
+
+
+// TwoWire::endTransmission
+//
+// Logs the transaction and charges its bus time to the simulated clock: a
+// start and stop condition plus nine clocks (eight bits and the ACK) for the
+// address byte and each data byte.
+//
+byte TwoWire::endTransmission() {
+  unsigned long long clocks;
+
+  if (!open)
+    return 4;
+
+  clocks = 2 + 9 * (1 + current.bytes.size());
+  hostGPIO.advance(clocks * 1000000000ULL / clockHz);
+
+  log.push_back(current);
+  open = false;
+  return 0;
+}
+
+
+void TwoWire::clearLog() {
+  log.clear();
+}
+
+
+// TwoWire::printLog
+//
+// Writes one line per logged transaction, splitting each one up by control
+// byte: "C" and "D" mark single command/data bytes framed with Co = 1, and
+// "C*"/"D*" mark the Co = 0 run that ends a transaction.
+//
+void TwoWire::printLog(FILE *out) {
+  for (size_t t = 0; t < log.size(); t++) {
+    const std::vector<byte> &bytes = log[t].bytes;
+    size_t i = 0;
+
+    fprintf(out, "%5u  t=%12.3fus  0x%02X:", (unsigned)t,
+            (log[t].ns - hostGPIO.logStartNs) / 1000.0, log[t].address);
+
+    while (i < bytes.size()) {
+      byte control = bytes[i++];
+      const char *type = (control & 0x40) ? "D" : "C";
+
+      if (control & 0x80) {
+        if (i < bytes.size())
+          fprintf(out, "  %s %02X", type, bytes[i++]);
+        continue;
+      }
+
+      fprintf(out, "  %s*", type);
+      while (i < bytes.size())
+        fprintf(out, " %02X", bytes[i++]);
+    }
+
+    fprintf(out, "\n");
+  }
+}
+
+
+// TwoWire::printSummary
+//
+// Writes totals for the logged transactions: how many display bytes were
+// carried, how many bytes of address and control framing it took, and the
+// resulting overhead per display byte.
+//
+void TwoWire::printSummary(FILE *out) {
+  unsigned long payload = 0, framing = 0;
+
+  for (size_t t = 0; t < log.size(); t++) {
+    const std::vector<byte> &bytes = log[t].bytes;
+    size_t i = 0;
+
+    framing++;  // Address byte
+    while (i < bytes.size()) {
+      byte control = bytes[i++];
+
+      framing++;
+      if (control & 0x80) {
+        if (i < bytes.size()) {
+          payload++;
+          i++;
+        }
+        continue;
+      }
+
+      payload += bytes.size() - i;
+      i = bytes.size();
+    }
+  }
+
+  fprintf(out, "Transactions:     %u\n", (unsigned)log.size());
+  fprintf(out, "Display bytes:    %lu\n", payload);
+  fprintf(out, "Framing bytes:    %lu (address + control)\n", framing);
+  if (payload)
+    fprintf(out, "Overhead:         %.2f framing bytes per display byte\n",
+            (double)framing / payload);
+}
+
+
+
+/*
+ * End of file!
+ */
@@ -0,0 +1,64 @@
+/*
+ * Newhaven Display Slim OLED Driver - Host Build Wire Stand-In
+ * ------------------------------------------------------------
+ *
+ * A minimal replacement for the Arduino Wire library. Transactions are
+ * logged instead of sent, and the simulated clock is charged for each one
+ * at the configured bus speed, so the driver's I2C framing can be examined
+ * on a desktop machine.
+ *
+ * Software License Agreement (BSD License) - see LICENSE.txt.
+ *
+ */
+
+
+
+#ifndef NHD_OLED_HOST_WIRE_H
+#define NHD_OLED_HOST_WIRE_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <vector>
+#include "Arduino.h"
+
+// Same transmit buffer size as the AVR Wire library.
+#define BUFFER_LENGTH 32
+
+// A single logged I2C write transaction, not counting the address byte.
+struct HostI2CTransaction {
+  unsigned long long ns;
+  byte address;
+  std::vector<byte> bytes;
+};
+
+class TwoWire {
+  public:
+    TwoWire();
+
+    void begin();
+    void setClock(unsigned long clock);
+    void beginTransmission(byte address);
+    size_t write(byte data);
+    byte endTransmission();
+
+    void clearLog();
+    void printLog(FILE *out);
+    void printSummary(FILE *out);
+
+    unsigned long clockHz;
+    std::vector<HostI2CTransaction> log;
+
+  private:
+    HostI2CTransaction current;
+    bool open;
+};
+
+extern TwoWire Wire;
+
+#endif
+
+
+
+/*
+ * End of file!
+ */
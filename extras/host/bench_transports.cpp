@@ -0,0 +1,145 @@
+/*
+ * Newhaven Display Slim OLED Driver - Transport Benchmark
+ * -------------------------------------------------------
+ *
+ * Times the same workloads over each transport against the simulated GPIO
+ * layer: bit-banged SPI, the 6800 and 8080 parallel buses, and I2C at 100kHz
+ * and 400kHz.
+ *
+ * Usage:
+ *   bench_transports [writeNs] [holdNs]
+ *
+ * The simulator models pin writes as digitalWrite() calls, so the parallel
+ * figures are for the portable path. On AVR with DB0-DB7 on one port the
+ * driver writes the data lines with a single port write instead, which is
+ * faster still.
+ *
+ * Software License Agreement (BSD License) - see LICENSE.txt.
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "HostGPIO.h"
+#include "Wire.h"
+#include "NHD_OLED_Driver.h"
+#include "NHD_OLED_I2C.h"
+
+
+
+static const byte pinDB[8] = {22, 23, 24, 25, 26, 27, 28, 29};
+
+static char row[] = "0123456789ABCDEFGHIJ";
+
+
+
+// Workloads
+
+static void workloadRepaint(NHD_OLED &oled) {
+  for (byte r = 0; r < 4; r++)
+    oled.print(row, 20, r, 0);
+}
+
+static void workloadCell(NHD_OLED &oled) {
+  oled.print('X', 2, 7);
+}
+
+struct Workload {
+  const char *name;
+  void (*run)(NHD_OLED &oled);
+};
+
+static const Workload workloads[] = {
+  {"20x4 repaint", workloadRepaint},
+  {"single cell",  workloadCell},
+};
+
+
+
+// Transports
+
+static void setupSPI(NHD_OLED &oled) {
+  oled.begin(2, 3, 4, 20);
+}
+
+static void setup6800(NHD_OLED &oled) {
+  oled.beginParallel(NHD_OLED_BUS_6800, 4, 5, pinDB, 4, 20);
+}
+
+static void setup8080(NHD_OLED &oled) {
+  oled.beginParallel(NHD_OLED_BUS_8080, 4, 5, pinDB, 4, 20);
+}
+
+static void setupI2C100(NHD_OLED &oled) {
+  oled.beginI2C(Wire, NHD_OLED_I2C_ADDRESS, 4, 20, 100000);
+}
+
+static void setupI2C400(NHD_OLED &oled) {
+  oled.beginI2C(Wire, NHD_OLED_I2C_ADDRESS, 4, 20, 400000);
+}
+
+struct Transport {
+  const char *name;
+  void (*setup)(NHD_OLED &oled);
+};
+
+static const Transport transports[] = {
+  {"SPI bit-bang",  setupSPI},
+  {"6800 parallel", setup6800},
+  {"8080 parallel", setup8080},
+  {"I2C 100kHz",    setupI2C100},
+  {"I2C 400kHz",    setupI2C400},
+};
+
+
+
+int main(int argc, char **argv) {
+  const size_t transportCount = sizeof(transports) / sizeof(transports[0]);
+  const size_t workloadCount = sizeof(workloads) / sizeof(workloads[0]);
+  double baseline[workloadCount];
+  size_t t, w;
+
+  if (argc > 1)
+    hostGPIO.writeNs = strtoul(argv[1], NULL, 10);
+  if (argc > 2)
+    hostGPIO.holdNs = strtoul(argv[2], NULL, 10);
+
+  printf("Simulated digitalWrite %luns, hold loop %luns\n\n",
+         hostGPIO.writeNs, hostGPIO.holdNs);
+  printf("%-16s", "");
+  for (w = 0; w < workloadCount; w++)
+    printf("  %22s", workloads[w].name);
+  printf("\n");
+
+  for (t = 0; t < transportCount; t++) {
+    NHD_OLED oled;
+
+    hostGPIO.reset();
+    transports[t].setup(oled);
+    printf("%-16s", transports[t].name);
+
+    for (w = 0; w < workloadCount; w++) {
+      unsigned long long start = hostGPIO.nowNs;
+      double us;
+
+      workloads[w].run(oled);
+      us = (hostGPIO.nowNs - start) / 1000.0;
+      if (t == 0)
+        baseline[w] = us;
+
+      printf("  %11.1fus (%5.1fx)", us, baseline[w] / us);
+    }
+
+    printf("\n");
+  }
+
+  return 0;
+}
+
+
+
+/*
+ * End of file!
+ */
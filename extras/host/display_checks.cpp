@@ -0,0 +1,784 @@
+/*
+ * Newhaven Display Slim OLED Driver - Display Behavior Checks
+ * -----------------------------------------------------------
+ *
+ * Drives the library's higher-level classes against the simulated GPIO
+ * layer, replays the decoded SPI traffic into a model of each display's
+ * DDRAM and checks both what ends up on screen and which cells were written
+ * to get there - so a redraw that happens to leave the right text behind
+ * but sends more than it should still fails.
+ *
+ * Usage:
+ *   display_checks [check]
+ *
+ * With no check named, every check is run. The exit status is non-zero if
+ * any of them fail.
+ *
+ * Software License Agreement (BSD License) - see LICENSE.txt.
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "HostGPIO.h"
+#include "Wire.h"
+#include "NHD_OLED_Driver.h"
+#include "NHD_OLED_I2C.h"
+#include "NHD_OLED_Frame.h"
+#include "NHD_OLED_Canvas.h"
+#include "NHD_OLED_Overlay.h"
+#include "NHD_OLED_Menu.h"
+#include "NHD_OLED_Watch.h"
+#include "NHD_OLED_Glyph.h"
+
+
+
+#define ROWS    4
+#define COLUMNS 20
+
+// Display Model - what one display holds, built from its SPI traffic.
+struct Model {
+  byte pinSCLK;
+  byte pinSDIN;
+  char ddram[128];
+  byte written[128];    // DDRAM cells written since the last mark()
+  unsigned long data;   // DDRAM data bytes since the last mark()
+  byte address;
+  byte extended;        // RE bit - commands are from the extended set
+  byte cgram;           // data goes to CGRAM, not DDRAM
+  byte oledSet;         // SD bit - commands are from the OLED set
+  byte doubleHeight;    // DH bit
+  byte pairCommand;     // last Double Height command (UD2/UD1 row pair)
+};
+
+static int failures;
+
+
+
+// Starts a model for the display on the given pins, blank.
+static void modelBegin(Model &model, byte pinSCLK, byte pinSDIN) {
+  memset(&model, 0, sizeof(model));
+  model.pinSCLK = pinSCLK;
+  model.pinSDIN = pinSDIN;
+  memset(model.ddram, ' ', sizeof(model.ddram));
+}
+
+
+// Forgets which cells have been written, ahead of the step being checked.
+static void mark(Model &model) {
+  memset(model.written, 0, sizeof(model.written));
+  model.data = 0;
+}
+
+
+// Replays decoded frames into a model, following the command set far
+// enough to know where each data byte lands.
+static void replay(Model &model, const std::vector<HostFrame> &frames) {
+  byte b;
+
+  for (size_t i = 0; i < frames.size(); i++) {
+    b = frames[i].payload;
+
+    if (!frames[i].isCommand) {
+      if (model.cgram)
+        continue;
+      model.ddram[model.address] = b;
+      model.written[model.address] = 1;
+      model.data++;
+      model.address = (model.address + 1) & 0x7F;
+    }
+    else if (model.oledSet) {
+      // OLED commands and their values, up to the command leaving the set.
+      if (b == 0x78)
+        model.oledSet = 0;
+    }
+    else if ((b & 0xE0) == 0x20) {
+      if (!(b & 0x02))
+        model.doubleHeight = (b & 0x04) ? 1 : 0;
+      model.extended = (b & 0x02) ? 1 : 0;
+    }
+    else if (model.extended) {
+      if (b == 0x79)
+        model.oledSet = 1;
+      else if ((b & 0xF0) == 0x10)
+        model.pairCommand = b;
+    }
+    else if (b == 0x01) {
+      memset(model.ddram, ' ', sizeof(model.ddram));
+      model.address = 0;
+      model.cgram = 0;
+    }
+    else if (b & 0x80) {
+      model.address = b & 0x7F;
+      model.cgram = 0;
+    }
+    else if (b & 0x40) {
+      model.cgram = 1;
+    }
+  }
+}
+
+
+// Decodes what has been sent to every modelled display since the last
+// capture, and replays it.
+static void capture(Model *models, int count) {
+  std::vector<HostFrame> frames;
+
+  for (int i = 0; i < count; i++) {
+    hostGPIO.decodeSPI(models[i].pinSCLK, models[i].pinSDIN, frames);
+    replay(models[i], frames);
+  }
+
+  hostGPIO.clearLog();
+}
+
+
+// Records a failure if ok is false.
+static void expect(bool ok, const char *what) {
+  if (!ok) {
+    printf("  FAILED: %s\n", what);
+    failures++;
+  }
+}
+
+
+// Checks that a DDRAM row starts with the given text.
+static bool shows(const Model &model, byte row, byte column,
+                  const char *text) {
+  return memcmp(model.ddram + row * 0x20 + column, text, strlen(text)) == 0;
+}
+
+
+// Decodes what one modelled display has been sent since the last capture,
+// replays it, and hands the frames back for checking byte by byte.
+static void captureFrames(Model &model, std::vector<HostFrame> &frames) {
+  hostGPIO.decodeSPI(model.pinSCLK, model.pinSDIN, frames);
+  replay(model, frames);
+  hostGPIO.clearLog();
+}
+
+
+// Checks that frames hold exactly one CGRAM upload: the given Set CGRAM
+// Address command, then the bitmap's 8 rows cut to 5 bits.
+static bool uploaded(const std::vector<HostFrame> &frames, byte command,
+                     const byte *bitmap) {
+  if ((frames.size() != 9) or !frames[0].isCommand or
+      (frames[0].payload != command))
+    return false;
+
+  for (int i = 0; i < 8; i++)
+    if (frames[1 + i].isCommand or (frames[1 + i].payload != bitmap[i]))
+      return false;
+
+  return true;
+}
+
+
+// Counts the cells written outside a rectangle of the display.
+static int writtenOutside(const Model &model, byte row, byte column,
+                          byte rows, byte columns) {
+  int count = 0;
+
+  for (int r = 0; r < ROWS; r++)
+    for (int c = 0; c < COLUMNS; c++)
+      if (model.written[r * 0x20 + c] and
+          !((r >= row) and (r < row + rows) and
+            (c >= column) and (c < column + columns)))
+        count++;
+
+  return count;
+}
+
+
+
+// Canvas - a 2x2 wall of 4x20 panels, checked where text meets the seams.
+
+static void checkCanvas() {
+  NHD_OLED displays[4];
+  NHD_OLED_Frame panels[4];
+  NHD_OLED_Canvas canvas;
+  Model models[4];
+  int i;
+
+  for (i = 0; i < 4; i++) {
+    displays[i].begin(2 + 2 * i, 3 + 2 * i, ROWS, COLUMNS);
+    panels[i].begin(displays[i]);
+    modelBegin(models[i], 2 + 2 * i, 3 + 2 * i);
+  }
+  canvas.begin(panels, 2, 2);
+  hostGPIO.clearLog();
+
+  expect((canvas.DISP_ROWS == 8) and (canvas.DISP_COLUMNS == 40),
+         "canvas is 8x40");
+
+  // Across the vertical seam.
+  canvas.print((char *)"Hello across the seam", 21, 1, 10);
+  canvas.flush();
+  capture(models, 4);
+  expect(shows(models[0], 1, 10, "Hello acro"), "left half of the split");
+  expect(shows(models[1], 1, 0, "ss the seam"), "right half of the split");
+  expect((models[0].data == 10) and (models[1].data == 11),
+         "each panel gets only its own part");
+  expect((models[2].data == 0) and (models[3].data == 0),
+         "lower panels untouched");
+
+  // Onto the lower panels, and off the right edge of the canvas.
+  for (i = 0; i < 4; i++)
+    mark(models[i]);
+  canvas.print((char *)"edge", 4, 4, 38);
+  canvas.print('X', 7, 39);
+  canvas.flush();
+  capture(models, 4);
+  expect(shows(models[3], 0, 18, "ed"), "text clipped at the right edge");
+  expect(shows(models[3], 3, 19, "X"), "bottom-right corner cell");
+  expect(models[3].data == 3, "clipped text isn't sent");
+  expect(models[0].data + models[1].data + models[2].data == 0,
+         "other panels untouched");
+
+  // A canvas row runs through both panels beside each other.
+  for (i = 0; i < 4; i++)
+    mark(models[i]);
+  canvas.textClearRow(1);
+  canvas.flush();
+  capture(models, 4);
+  expect(shows(models[0], 1, 10, "          ") and
+         shows(models[1], 1, 0, "           "), "row cleared on both panels");
+  expect((writtenOutside(models[0], 1, 0, 1, COLUMNS) == 0) and
+         (writtenOutside(models[1], 1, 0, 1, COLUMNS) == 0),
+         "clearing a row only touches that row");
+}
+
+
+
+// Budgets - a budgeted flush keeps to its budget on every transport, even
+// before calibration, and a canvas sends rows in priority order across all
+// of its panels.
+
+static void fill(NHD_OLED_Frame &frame) {
+  char text[COLUMNS];
+
+  for (byte r = 0; r < ROWS; r++) {
+    for (byte c = 0; c < COLUMNS; c++)
+      text[c] = 'A' + (r * 7 + c) % 26;
+    frame.print(text, COLUMNS, r, 0);
+  }
+}
+
+static void checkBudget() {
+  static const unsigned long budgets[] = {500, 1000, 2000};
+  NHD_OLED bare, displays[2];
+  NHD_OLED_Frame frame, panels[2];
+  NHD_OLED_Canvas canvas;
+  Model models[2];
+  unsigned long long started, took, worst;
+  unsigned int left;
+  char what[64];
+  size_t b;
+  int i;
+
+  // Set up by hand, with no calibration to base costs on.
+  bare.setupPins(2, 3);
+  bare.setupDisplaySize(ROWS, COLUMNS);
+  bare.setupInit();
+  frame.begin(bare);
+  fill(frame);
+  expect(bare.costDataNs != 0, "costs estimated without calibration");
+  expect(frame.flush(0) == ROWS * COLUMNS, "zero budget sends nothing");
+
+  // Over I2C the runs are only buffered until the batch ends.
+  for (b = 0; b < sizeof(budgets) / sizeof(budgets[0]); b++) {
+    NHD_OLED oled;
+    NHD_OLED_Frame i2cFrame;
+
+    oled.beginI2C(Wire, NHD_OLED_I2C_ADDRESS, ROWS, COLUMNS, 100000);
+    i2cFrame.begin(oled);
+    fill(i2cFrame);
+
+    worst = 0;
+    for (i = 0; i < 200; i++) {
+      started = hostGPIO.nowNs;
+      left = i2cFrame.flush(budgets[b]);
+      took = (hostGPIO.nowNs - started) / 1000;
+      if (took > worst)
+        worst = took;
+      if (left == 0)
+        break;
+    }
+
+    snprintf(what, sizeof(what), "100kHz I2C flush(%lu) within 5%% (%lluus)",
+             budgets[b], worst);
+    expect((left == 0) and (worst <= budgets[b] + budgets[b] / 20), what);
+  }
+  Wire.clearLog();
+
+  // Two panels stacked; the top priority row is on the lower one.
+  for (i = 0; i < 2; i++) {
+    displays[i].begin(2 + 2 * i, 3 + 2 * i, ROWS, COLUMNS);
+    panels[i].begin(displays[i]);
+    modelBegin(models[i], 2 + 2 * i, 3 + 2 * i);
+    fill(panels[i]);
+  }
+  canvas.begin(panels, 1, 2);
+  canvas.setRowPriority(6, 200);
+  hostGPIO.clearLog();
+
+  canvas.flush(displays[1].costCommandNs / 1000 +
+               COLUMNS * displays[1].costDataNs / 1000 + 100);
+  capture(models, 2);
+  expect((models[0].data == 0) and (models[1].data > 0) and
+         (writtenOutside(models[1], 2, 0, 1, COLUMNS) == 0),
+         "high-priority row on the lower panel goes first");
+}
+
+
+
+// Overlay - showing and hiding only costs the cells the box covers, and
+// hiding puts back exactly what the frame holds underneath.
+
+static void checkOverlay() {
+  NHD_OLED oled;
+  NHD_OLED_Frame frame;
+  NHD_OLED_Overlay box, top;
+  Model model;
+  char under[4][21];
+  char boxCells[2 * 10 + 1], topCells[2 * 6 + 1];
+  int r;
+
+  oled.begin(2, 3, ROWS, COLUMNS);
+  frame.begin(oled);
+  modelBegin(model, 2, 3);
+
+  for (r = 0; r < ROWS; r++) {
+    snprintf(under[r], sizeof(under[r]), "row %d: underneath %d", r, r);
+    frame.print(under[r], COLUMNS, r, 0);
+  }
+  frame.flush();
+  capture(&model, 1);
+
+  // Guard bytes just past each buffer catch an overlay writing beyond its
+  // own rows * columns.
+  boxCells[20] = '!';
+  topCells[12] = '!';
+  box.begin(boxCells, 1, 5, 2, 10);
+  box.print((char *)"+--------+", 10, 0, 0);
+  box.print((char *)"| ALARM! |", 10, 1, 0);
+  top.begin(topCells, 2, 12, 2, 6);
+  top.print((char *)"######", 6, 1, 0);
+  top.print((char *)"too long to fit", 15, 0, 0);
+  expect((boxCells[20] == '!') and (topCells[12] == '!'),
+         "overlays stay inside their buffers");
+
+  mark(model);
+  frame.show(box);
+  frame.flush();
+  capture(&model, 1);
+  expect(shows(model, 1, 5, "+--------+") and shows(model, 2, 5, "| ALARM! |"),
+         "box shown");
+  expect(writtenOutside(model, 1, 5, 2, 10) == 0,
+         "showing touches only the box");
+
+  mark(model);
+  frame.show(top);
+  frame.flush();
+  capture(&model, 1);
+  expect(shows(model, 2, 12, "too lo") and shows(model, 3, 12, "######"),
+         "second overlay on top");
+  expect(writtenOutside(model, 2, 12, 2, 6) == 0,
+         "second overlay touches only its own cells");
+
+  // Hiding the lower box must leave the upper one alone where they overlap.
+  mark(model);
+  frame.hide(box);
+  frame.flush();
+  capture(&model, 1);
+  expect(shows(model, 1, 0, under[1]) and shows(model, 2, 0, "row 2: under"),
+         "frame content restored under the box");
+  expect(shows(model, 2, 12, "too lo"), "overlapping overlay kept");
+  expect((writtenOutside(model, 1, 5, 2, 10) == 0) and
+         !model.written[2 * 0x20 + 12] and !model.written[2 * 0x20 + 14],
+         "hiding touches only the uncovered part of the box");
+
+  mark(model);
+  frame.hide(top);
+  frame.flush();
+  capture(&model, 1);
+  for (r = 0; r < ROWS; r++)
+    expect(shows(model, r, 0, under[r]), "frame fully restored");
+  expect(writtenOutside(model, 2, 12, 2, 6) == 0,
+         "hiding touches only the overlay's cells");
+}
+
+
+
+// Menu - moving the selection within the window only redraws the marker
+// column, and nothing is drawn outside the window.
+
+extern const NHD_OLED_MenuList mainMenu, setupMenu;
+
+static const char itemStatus[] PROGMEM = "Status";
+static const char itemSetup[] PROGMEM = "Setup";
+static const char itemLog[] PROGMEM = "Alarm log";
+static const char itemAbout[] PROGMEM = "About";
+static const char itemContrast[] PROGMEM = "Contrast";
+static const char itemUnits[] PROGMEM = "Units";
+
+static const NHD_OLED_MenuItem mainItems[] PROGMEM = {
+  {itemStatus, 0, 1},
+  {itemSetup, &setupMenu, 0},
+  {itemLog, 0, 2},
+  {itemAbout, 0, 3},
+};
+
+static const NHD_OLED_MenuItem setupItems[] PROGMEM = {
+  {itemContrast, 0, 10},
+  {itemUnits, 0, 11},
+};
+
+const NHD_OLED_MenuList mainMenu PROGMEM = {0, 0, 4, mainItems};
+const NHD_OLED_MenuList setupMenu PROGMEM = {&mainMenu, 1, 2, setupItems};
+
+static void checkMenu() {
+  NHD_OLED oled;
+  NHD_OLED_Menu menu, offscreen;
+  Model model;
+
+  oled.begin(2, 3, ROWS, COLUMNS);
+  modelBegin(model, 2, 3);
+  hostGPIO.clearLog();
+
+  // A two-row window on rows 1 and 2.
+  menu.begin(oled, &mainMenu, 1, 2);
+  capture(&model, 1);
+  expect(shows(model, 1, 0, ">Status ") and shows(model, 2, 0, " Setup "),
+         "window drawn");
+  expect(writtenOutside(model, 1, 0, 2, COLUMNS) == 0,
+         "nothing drawn outside the window");
+
+  mark(model);
+  menu.next();
+  capture(&model, 1);
+  expect(shows(model, 1, 0, " Status") and shows(model, 2, 0, ">Setup"),
+         "marker moved down");
+  expect((model.data == 2) and (writtenOutside(model, 1, 0, 2, 1) == 0),
+         "moving the marker only redraws the marker column");
+
+  mark(model);
+  menu.previous();
+  capture(&model, 1);
+  expect(shows(model, 1, 0, ">Status") and (model.data == 2),
+         "marker moved back up");
+
+  // Scrolling redraws the labels, still inside the window.
+  mark(model);
+  menu.next();
+  menu.next();
+  capture(&model, 1);
+  expect(shows(model, 1, 0, " Setup     ") and
+         shows(model, 2, 0, ">Alarm log "), "window scrolled");
+  expect(writtenOutside(model, 1, 0, 2, COLUMNS) == 0,
+         "scrolling stays inside the window");
+
+  menu.previous();
+  expect(menu.enter() == 0, "submenu entry opens its list");
+  mark(model);
+  menu.back();
+  capture(&model, 1);
+  expect(shows(model, 1, 0, " Status    ") and
+         shows(model, 2, 0, ">Setup     "), "back to the parent entry");
+
+  // A window starting below the display draws nothing at all.
+  mark(model);
+  offscreen.begin(oled, &mainMenu, ROWS);
+  offscreen.next();
+  offscreen.enter();
+  offscreen.begin(oled, &mainMenu, 200, 2);
+  offscreen.redraw();
+  capture(&model, 1);
+  expect(model.data == 0, "off-screen window draws nothing");
+}
+
+
+
+// Watch - a changed value only sends the characters that differ, and a
+// field that can't fit its value shows #s without writing past its buffer.
+
+static const char stateIdle[] PROGMEM = "Idle";
+static const char stateHeating[] PROGMEM = "Heating";
+static const char * const states[] PROGMEM = {stateIdle, stateHeating};
+
+static void checkWatch() {
+  NHD_OLED oled;
+  NHD_OLED_Watch watch;
+  NHD_OLED_Field counter, temperature, state, tiny;
+  Model model;
+  int count = 1234, temp = -5, small = -5;
+  byte mode = 0;
+
+  oled.begin(2, 3, ROWS, COLUMNS);
+  modelBegin(model, 2, 3);
+  watch.begin(oled);
+
+  counter.bindInt(&count, 0, 0, 6);
+  temperature.bindFixed(&temp, 2, 1, 0, 7);
+  state.bindLabel(&mode, states, 2, 2, 0, 8);
+  tiny.bindFixed(&small, 20, 3, 0, COLUMNS);
+  watch.add(counter);
+  watch.add(temperature, 100);
+  watch.add(state);
+  watch.add(tiny);
+  hostGPIO.clearLog();
+
+  watch.refresh();
+  capture(&model, 1);
+  expect(shows(model, 0, 0, "  1234") and shows(model, 1, 0, "  -0.05") and
+         shows(model, 2, 0, "Idle    "), "fields drawn");
+  expect(shows(model, 3, 0, "####################"),
+         "value too long for its field shows #s");
+
+  mark(model);
+  watch.refresh();
+  capture(&model, 1);
+  expect(model.data == 0, "nothing sent when nothing changed");
+
+  mark(model);
+  count = 1235;
+  watch.refresh();
+  capture(&model, 1);
+  expect(shows(model, 0, 0, "  1235") and (model.data == 1) and
+         model.written[5], "one digit changed, one cell sent");
+
+  mark(model);
+  count = 1299;
+  watch.refresh();
+  capture(&model, 1);
+  expect(shows(model, 0, 0, "  1299") and (model.data == 2) and
+         (writtenOutside(model, 0, 4, 1, 2) == 0), "two digits, two cells");
+
+  mark(model);
+  mode = 1;
+  watch.refresh();
+  capture(&model, 1);
+  expect(shows(model, 2, 0, "Heating ") and
+         (writtenOutside(model, 2, 0, 1, 8) == 0), "label redrawn in place");
+
+  // The temperature field is refreshed at most every 100ms.
+  mark(model);
+  temp = 2150;
+  watch.refresh();
+  capture(&model, 1);
+  expect(model.data == 0, "rate-limited field waits");
+  delay(100);
+  watch.refresh();
+  capture(&model, 1);
+  expect(shows(model, 1, 0, "  21.50") and
+         (writtenOutside(model, 1, 0, 1, 7) == 0), "rate-limited field sent");
+}
+
+
+
+// Double height - rows are numbered as they appear, whichever pairs are
+// merged, and setupInit() takes the line count from DISP_ROWS.
+
+static void checkDoubleHeight() {
+  // Each mode as the US2066 datasheet's Double Height command table lays it
+  // out, written out here rather than worked out from the UD2/UD1 bits: the
+  // row-pair command, then the DDRAM row shown on each line, top to bottom.
+  // A merged line shows its upper row; -1 ends the list.
+  static const struct {
+    byte mode;
+    byte command;
+    signed char rows[5];
+  } expected[] = {
+    {NHD_OLED_DOUBLE_NONE,   0x00, {0, 1, 2, 3, -1}},
+    {NHD_OLED_DOUBLE_TOP,    0x10, {0, 2, 3, -1}},      // UD2/UD1 = 00
+    {NHD_OLED_DOUBLE_MIDDLE, 0x14, {0, 1, 3, -1}},      // 01
+    {NHD_OLED_DOUBLE_BOTTOM, 0x1C, {0, 1, 2, -1}},      // 11
+    {NHD_OLED_DOUBLE_BOTH,   0x18, {0, 2, -1}},         // 10
+    {NHD_OLED_DOUBLE_NONE,   0x00, {0, 1, 2, 3, -1}},
+  };
+  NHD_OLED oled, small;
+  Model model, smallModel;
+  char text[12];
+  byte i;
+  size_t m;
+
+  // Geometry set by hand rather than through setupDisplaySize(). Only a
+  // display set up for 4 lines accepts a mode that merges two pairs.
+  oled.setupPins(2, 3);
+  oled.DISP_ROWS = ROWS;
+  oled.DISP_COLUMNS = COLUMNS;
+  oled.setupInit();
+  expect(oled.DISP_ROWS == 4, "setupInit() keeps DISP_ROWS");
+  oled.displayDoubleHeight(NHD_OLED_DOUBLE_BOTH);
+  expect(oled.DISP_ROWS == 2, "setupInit() takes 4 lines from DISP_ROWS");
+  oled.setupInit();
+  expect((oled.DISP_ROWS == 4) and
+         (oled.doubleHeight == NHD_OLED_DOUBLE_NONE),
+         "setupInit() leaves double height");
+
+  // The model starts from the normal-height display setupInit() leaves.
+  hostGPIO.clearLog();
+  modelBegin(model, 2, 3);
+
+  for (m = 0; m < sizeof(expected) / sizeof(expected[0]); m++) {
+    model.pairCommand = 0x00;
+    oled.displayDoubleHeight(expected[m].mode);
+    oled.textClear();
+    for (i = 0; i < oled.DISP_ROWS; i++) {
+      snprintf(text, sizeof(text), "line %d", i);
+      oled.print(text, strlen(text), i, 0);
+    }
+    oled.print((char *)"!", 1, 9, 19);
+    capture(&model, 1);
+
+    expect(!model.extended, "back in the fundamental command set");
+    expect(model.doubleHeight == (expected[m].command != 0x00),
+           "double height bit set only when rows are merged");
+    expect(model.pairCommand == expected[m].command,
+           "row-pair command matches the datasheet");
+    for (i = 0; expected[m].rows[i] >= 0; i++) {
+      snprintf(text, sizeof(text), "line %d", i);
+      expect(shows(model, expected[m].rows[i], 0, text),
+             "line shows its own row");
+    }
+    expect(i == oled.DISP_ROWS, "DISP_ROWS matches the visible lines");
+    expect(shows(model, expected[m].rows[i - 1], 19, "!"),
+           "rows past the end land on the last line");
+  }
+
+  // A 2-line display only merges its one pair.
+  small.begin(4, 5, 2, 16);
+  hostGPIO.clearLog();
+  modelBegin(smallModel, 4, 5);
+  small.displayDoubleHeight(NHD_OLED_DOUBLE_MIDDLE);
+  expect(small.DISP_ROWS == 2, "2-line display ignores other pairs");
+  small.displayDoubleHeight(NHD_OLED_DOUBLE_TOP);
+  small.print((char *)"BIG", 3, 1, 0);
+  capture(&smallModel, 1);
+  expect((small.DISP_ROWS == 1) and smallModel.doubleHeight and
+         (smallModel.pairCommand == 0x10) and
+         shows(smallModel, 0, 0, "BIG"), "2-line display shows one big line");
+}
+
+
+
+// Glyph - CGRAM uploads for the first and last slots, an empty animation,
+// and createChar() from RAM.
+
+static void checkGlyph() {
+  static const byte bitmaps[16] PROGMEM = {
+    0x04, 0x0E, 0x1F, 0x0E, 0x04, 0x00, 0x00, 0x00,
+    0xFF, 0x31, 0x51, 0x91, 0x11, 0x11, 0xFF, 0x00,   // top bits set
+  };
+  // What the display should be sent for each frame, written out by hand.
+  static const byte rows[2][8] = {
+    {0x04, 0x0E, 0x1F, 0x0E, 0x04, 0x00, 0x00, 0x00},
+    {0x1F, 0x11, 0x11, 0x11, 0x11, 0x11, 0x1F, 0x00},
+  };
+  byte ram[8];
+  NHD_OLED oled;
+  NHD_OLED_Glyph first, last, empty;
+  Model model;
+  std::vector<HostFrame> frames;
+
+  oled.begin(2, 3, ROWS, COLUMNS);
+  hostGPIO.clearLog();
+  modelBegin(model, 2, 3);
+
+  first.begin(oled, 0, bitmaps, 2, 100);
+  captureFrames(model, frames);
+  expect(uploaded(frames, 0x40, rows[0]), "slot 0 gets its first frame");
+
+  last.begin(oled, 7, bitmaps, 2, 100);
+  captureFrames(model, frames);
+  expect(uploaded(frames, 0x78, rows[0]), "slot 7 gets its first frame");
+
+  // Each animation steps on into its own slot, high bits dropped.
+  delay(100);
+  expect(first.tick(), "slot 0 advances after the interval");
+  captureFrames(model, frames);
+  expect(uploaded(frames, 0x40, rows[1]), "slot 0 gets its second frame");
+  expect(last.tick(), "slot 7 advances after the interval");
+  captureFrames(model, frames);
+  expect(uploaded(frames, 0x78, rows[1]), "slot 7 gets its second frame");
+
+  // No frames: nothing is ever sent.
+  empty.begin(oled, 3, bitmaps, 0, 100);
+  delay(100);
+  expect(!empty.tick(), "an empty animation never ticks");
+  captureFrames(model, frames);
+  expect(frames.empty(), "an empty animation sends nothing");
+
+  // createChar() takes its bitmap from RAM, through the same upload.
+  memcpy(ram, rows[1], sizeof(ram));
+  ram[6] = 0xFF;
+  oled.createChar(5, (char *)ram);
+  captureFrames(model, frames);
+  expect(uploaded(frames, 0x68, rows[1]), "createChar() writes slot 5");
+
+  // Uploads stay out of DDRAM, and text goes back to DDRAM after a move.
+  expect(model.data == 0, "uploads write no DDRAM cells");
+  oled.print((char)5, 1, 4);
+  capture(&model, 1);
+  expect((model.data == 1) and shows(model, 1, 4, "\x05"),
+         "printing after an upload lands in DDRAM");
+}
+
+
+
+struct Check {
+  const char *name;
+  void (*run)();
+};
+
+static const Check checks[] = {
+  {"canvas",  checkCanvas},
+  {"budget",  checkBudget},
+  {"overlay", checkOverlay},
+  {"menu",    checkMenu},
+  {"watch",   checkWatch},
+  {"double",  checkDoubleHeight},
+  {"glyph",   checkGlyph},
+};
+
+
+
+int main(int argc, char **argv) {
+  const char *only = (argc > 1) ? argv[1] : NULL;
+  size_t i;
+  int before;
+  bool found = false;
+
+  for (i = 0; i < sizeof(checks) / sizeof(checks[0]); i++) {
+    if (only && strcmp(only, checks[i].name) != 0)
+      continue;
+
+    printf("%s\n", checks[i].name);
+    before = failures;
+    checks[i].run();
+    if (failures == before)
+      printf("  ok\n");
+    found = true;
+  }
+
+  if (!found) {
+    fprintf(stderr, "Unknown check \"%s\". Choose from:", only);
+    for (i = 0; i < sizeof(checks) / sizeof(checks[0]); i++)
+      fprintf(stderr, " %s", checks[i].name);
+    fprintf(stderr, "\n");
+    return 1;
+  }
+
+  printf("%s\n", failures ? "FAILED" : "All checks passed");
+  return failures ? 1 : 0;
+}
+
+
+
+/*
+ * End of file!
+ */
@@ -0,0 +1,107 @@
+/*
+ * Newhaven Display Slim OLED Driver - I2C Capture Tool
+ * ----------------------------------------------------
+ *
+ * Runs driver API calls over the I2C transport against the Wire stand-in and
+ * prints every transaction split up by control byte, along with how many
+ * framing bytes each display byte cost.
+ *
+ * Usage:
+ *   i2c_capture [scenario] [clockHz]
+ *
+ * Software License Agreement (BSD License) - see LICENSE.txt.
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "HostGPIO.h"
+#include "Wire.h"
+#include "NHD_OLED_Driver.h"
+#include "NHD_OLED_I2C.h"
+
+
+
+NHD_OLED oled;
+
+
+
+// Scenarios - each one is a short burst of API calls worth measuring.
+
+static void scenarioInit() {
+  oled.setupInit();
+}
+
+static void scenarioPrint() {
+  oled.print((char *)"Hello World!", 12, 0, 0);
+}
+
+static void scenarioCentered() {
+  oled.textPrintCentered((char *)"Centered", 8, 1);
+}
+
+static void scenarioSingles() {
+  oled.print('A', 0, 0);
+  oled.print('B', 1, 5);
+  oled.print('C', 2, 10);
+}
+
+struct Scenario {
+  const char *name;
+  void (*run)();
+};
+
+static const Scenario scenarios[] = {
+  {"init",     scenarioInit},
+  {"print",    scenarioPrint},
+  {"centered", scenarioCentered},
+  {"singles",  scenarioSingles},
+};
+
+
+
+int main(int argc, char **argv) {
+  const char *only = (argc > 1) ? argv[1] : NULL;
+  unsigned long long start;
+  size_t i;
+  unsigned long clock = NHD_OLED_I2C_CLOCK;
+  bool found = false;
+
+  if (argc > 2)
+    clock = strtoul(argv[2], NULL, 10);
+
+  oled.beginI2C(Wire, NHD_OLED_I2C_ADDRESS, 4, 20, clock);
+
+  for (i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+    if (only && strcmp(only, scenarios[i].name) != 0)
+      continue;
+
+    hostGPIO.clearLog();
+    Wire.clearLog();
+    start = hostGPIO.nowNs;
+    scenarios[i].run();
+
+    printf("=== %s ===\n", scenarios[i].name);
+    Wire.printLog(stdout);
+    Wire.printSummary(stdout);
+    printf("Elapsed:          %.3f us (including driver delays)\n\n",
+           (hostGPIO.nowNs - start) / 1000.0);
+    found = true;
+  }
+
+  if (!found) {
+    fprintf(stderr, "Unknown scenario \"%s\".\n", only);
+    return 1;
+  }
+
+  return 0;
+}
+
+
+
+/*
+ * End of file!
+ */
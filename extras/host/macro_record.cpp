@@ -0,0 +1,261 @@
+/*
+ * Newhaven Display Slim OLED Driver - Macro Recorder
+ * --------------------------------------------------
+ *
+ * Records a run of ordinary driver API calls against the simulated GPIO
+ * layer and encodes everything that reached the display - commands, data
+ * and the delays between them - as a macro stream for NHD_OLED::macroPlay().
+ * The stream is printed as a PROGMEM array, ready to paste into a sketch.
+ *
+ * Before printing, the stream is played back through macroPlay() on the
+ * simulator and the result is checked against the original recording.
+ *
+ * Usage:
+ *   macro_record [template] [array name]
+ *
+ * Add your own templates to the table below - draw the screen exactly as
+ * the sketch would, using any API calls you like.
+ *
+ * Software License Agreement (BSD License) - see LICENSE.txt.
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "HostGPIO.h"
+#include "NHD_OLED_Driver.h"
+
+
+
+#define PIN_SCLK 2
+#define PIN_SDIN 3
+
+NHD_OLED oled;
+
+
+
+// Templates - each one draws a static screen.
+
+static void templateDashboard() {
+  char degree[8] = {0x06, 0x09, 0x09, 0x06, 0x00, 0x00, 0x00, 0x00};
+
+  oled.textClear();
+  oled.createChar(1, degree);
+  oled.print((char *)"Temp:", 5, 0, 0);
+  oled.print((char)1, 0, 12);
+  oled.print('C', 0, 13);
+  oled.print((char *)"Flow:", 5, 1, 0);
+  oled.print((char *)"l/min", 5, 1, 13);
+  oled.cursorPos(2, 0);
+  oled.fillRun('-', 20);
+  oled.textPrintCentered((char *)"[ OK ]", 6, 3);
+}
+
+static void templateSplash() {
+  oled.textClear();
+  oled.textPrintCentered((char *)"Newhaven Display", 16, 1);
+  oled.textPrintCentered((char *)"Slim OLED", 9, 2);
+}
+
+struct Template {
+  const char *name;
+  void (*run)();
+};
+
+static const Template templates[] = {
+  {"dashboard", templateDashboard},
+  {"splash",    templateSplash},
+};
+
+
+
+// A recorded event: a command or data byte, or a delay in milliseconds.
+struct Event {
+  byte kind;
+  unsigned long value;
+};
+
+#define EVENT_DATA    0
+#define EVENT_COMMAND 1
+#define EVENT_DELAY   2
+
+
+// Turns the simulator's log into events. Any idle stretch of a millisecond
+// or more - between frames, or after the last one - is taken as a delay.
+static void record(std::vector<Event> &events) {
+  std::vector<HostFrame> frames;
+  unsigned long long idleFrom;
+  Event event;
+
+  hostGPIO.decodeSPI(PIN_SCLK, PIN_SDIN, frames);
+
+  idleFrom = hostGPIO.logStartNs;
+  for (size_t i = 0; i <= frames.size(); i++) {
+    unsigned long long until = (i < frames.size()) ? frames[i].startNs
+                                                    : hostGPIO.nowNs;
+
+    if (until - idleFrom >= 1000000ULL) {
+      event.kind = EVENT_DELAY;
+      event.value = (until - idleFrom) / 1000000ULL;
+      events.push_back(event);
+    }
+
+    if (i == frames.size())
+      break;
+
+    event.kind = frames[i].isCommand ? EVENT_COMMAND : EVENT_DATA;
+    event.value = frames[i].payload;
+    events.push_back(event);
+    idleFrom = frames[i].endNs;
+  }
+}
+
+
+// Encodes events as a macro stream.
+static void encode(const std::vector<Event> &events,
+                   std::vector<byte> &stream) {
+  size_t i = 0, j, run;
+  unsigned long ms;
+
+  while (i < events.size()) {
+    const Event &e = events[i];
+
+    if (e.kind == EVENT_DELAY) {
+      for (ms = e.value; ms > 0; ms -= (ms > 63) ? 63 : ms)
+        stream.push_back(NHD_OLED_MACRO_DELAY | ((ms > 63) ? 63 : ms));
+      i++;
+      continue;
+    }
+
+    // Length of the run of events of this kind, up to one opcode's worth.
+    for (j = i; (j < events.size()) and (j - i < 63) and
+                (events[j].kind == e.kind); j++)
+      ;
+
+    if (e.kind == EVENT_COMMAND) {
+      stream.push_back(NHD_OLED_MACRO_COMMANDS | (j - i));
+      for (; i < j; i++)
+        stream.push_back(events[i].value);
+      continue;
+    }
+
+    // Data - three or more of the same byte in a row are cheaper repeated.
+    for (run = 1; (i + run < j) and (events[i + run].value == e.value);
+         run++)
+      ;
+    if (run >= 3) {
+      stream.push_back(NHD_OLED_MACRO_REPEAT | run);
+      stream.push_back(e.value);
+      i += run;
+      continue;
+    }
+
+    // Otherwise a plain data run, stopping where a repeat would start.
+    for (j = i; (j < events.size()) and (j - i < 63) and
+                (events[j].kind == EVENT_DATA); j++) {
+      if ((j + 2 < events.size()) and
+          (events[j + 1].kind == EVENT_DATA) and
+          (events[j + 2].kind == EVENT_DATA) and
+          (events[j].value == events[j + 1].value) and
+          (events[j].value == events[j + 2].value) and (j > i))
+        break;
+    }
+
+    stream.push_back(NHD_OLED_MACRO_DATA | (j - i));
+    for (; i < j; i++)
+      stream.push_back(events[i].value);
+  }
+
+  stream.push_back(NHD_OLED_MACRO_END);
+}
+
+
+static bool same(const std::vector<Event> &a, const std::vector<Event> &b) {
+  if (a.size() != b.size())
+    return false;
+
+  for (size_t i = 0; i < a.size(); i++)
+    if ((a[i].kind != b[i].kind) or (a[i].value != b[i].value))
+      return false;
+
+  return true;
+}
+
+
+static void print(const char *name, const std::vector<byte> &stream) {
+  printf("const byte %s[] PROGMEM = {", name);
+  for (size_t i = 0; i < stream.size(); i++) {
+    if (i % 12 == 0)
+      printf("\n ");
+    printf(" 0x%02X%s", stream[i], (i + 1 < stream.size()) ? "," : "");
+  }
+  printf("\n};\n");
+}
+
+
+int main(int argc, char **argv) {
+  const char *only = (argc > 1) ? argv[1] : "dashboard";
+  const char *name = (argc > 2) ? argv[2] : NULL;
+  const Template *chosen = NULL;
+  std::vector<Event> recorded, replayed;
+  std::vector<byte> stream;
+  unsigned long long recordedNs, replayedNs;
+  size_t i, commands = 0, data = 0;
+
+  for (i = 0; i < sizeof(templates) / sizeof(templates[0]); i++)
+    if (strcmp(only, templates[i].name) == 0)
+      chosen = &templates[i];
+
+  if (chosen == NULL) {
+    fprintf(stderr, "Unknown template \"%s\". Choose from:", only);
+    for (i = 0; i < sizeof(templates) / sizeof(templates[0]); i++)
+      fprintf(stderr, " %s", templates[i].name);
+    fprintf(stderr, "\n");
+    return 1;
+  }
+
+  oled.begin(PIN_SCLK, PIN_SDIN, 4, 20);
+
+  // Record the template...
+  hostGPIO.clearLog();
+  chosen->run();
+  recordedNs = hostGPIO.nowNs - hostGPIO.logStartNs;
+  record(recorded);
+  encode(recorded, stream);
+
+  // ... then play the stream back and make sure it does the same thing.
+  hostGPIO.clearLog();
+  oled.macroPlay(&stream[0]);
+  replayedNs = hostGPIO.nowNs - hostGPIO.logStartNs;
+  record(replayed);
+
+  if (!same(recorded, replayed)) {
+    fprintf(stderr, "Replay doesn't match the recording!\n");
+    return 1;
+  }
+
+  for (i = 0; i < recorded.size(); i++) {
+    if (recorded[i].kind == EVENT_COMMAND)
+      commands++;
+    else if (recorded[i].kind == EVENT_DATA)
+      data++;
+  }
+
+  printf("// Template \"%s\": %u commands and %u data bytes in a %u-byte "
+         "stream.\n", chosen->name, (unsigned)commands, (unsigned)data,
+         (unsigned)stream.size());
+  printf("// Simulated time: %lluus recorded, %lluus replayed.\n",
+         recordedNs / 1000, replayedNs / 1000);
+  print(name ? name : chosen->name, stream);
+
+  return 0;
+}
+
+
+
+/*
+ * End of file!
+ */
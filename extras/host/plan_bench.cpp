@@ -0,0 +1,130 @@
+/*
+ * Newhaven Display Slim OLED Driver - Flush Planner Benchmark
+ * -----------------------------------------------------------
+ *
+ * Runs screen updates through NHD_OLED_Frame over SPI and I2C and prints the
+ * plan the frame chose, the estimated cost of every plan, and how long the
+ * chosen plan actually took on the simulated bus.
+ *
+ * Usage:
+ *   plan_bench [writeNs]
+ *
+ * Software License Agreement (BSD License) - see LICENSE.txt.
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "HostGPIO.h"
+#include "Wire.h"
+#include "NHD_OLED_Driver.h"
+#include "NHD_OLED_I2C.h"
+#include "NHD_OLED_Frame.h"
+
+
+
+static const char *planNames[] = {"none", "cells", "rows", "clear"};
+
+static char full[] = "The quick brown fox jumps over a lazy dog";
+
+
+
+// Scenarios - each one starts from a full screen of text.
+
+static void fill(NHD_OLED_Frame &frame) {
+  for (byte r = 0; r < 4; r++)
+    frame.print(full + r * 5, 20, r, 0);
+}
+
+static void scenarioCell(NHD_OLED_Frame &frame) {
+  frame.print('!', 2, 9);
+}
+
+static void scenarioWord(NHD_OLED_Frame &frame) {
+  frame.print((char *)"Ab", 2, 3, 2);
+  frame.print((char *)"Cd", 2, 3, 6);
+}
+
+static void scenarioScreen(NHD_OLED_Frame &frame) {
+  for (byte r = 0; r < 4; r++)
+    frame.print(full + 20 - r * 4, 20, r, 0);
+}
+
+static void scenarioBlank(NHD_OLED_Frame &frame) {
+  frame.textClear();
+  frame.print((char *)"OK", 2, 1, 9);
+}
+
+struct Scenario {
+  const char *name;
+  void (*run)(NHD_OLED_Frame &frame);
+};
+
+static const Scenario scenarios[] = {
+  {"one cell",     scenarioCell},
+  {"two words",    scenarioWord},
+  {"new screen",   scenarioScreen},
+  {"mostly blank", scenarioBlank},
+};
+
+
+
+static void bench(const char *name, NHD_OLED &oled) {
+  NHD_OLED_Frame frame;
+  size_t i;
+
+  printf("%s - data %.1fus, command %.1fus\n", name,
+         oled.costDataNs / 1000.0, oled.costCommandNs / 1000.0);
+  printf("  %-14s %-6s %4s %4s %10s %10s %10s %10s\n", "", "plan", "cmd",
+         "data", "cells", "rows", "clear", "actual");
+
+  frame.begin(oled);
+
+  for (i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+    unsigned long long start;
+
+    fill(frame);
+    frame.flush();
+
+    scenarios[i].run(frame);
+    start = hostGPIO.nowNs;
+    frame.flush();
+
+    printf("  %-14s %-6s %4u %4u %8.1fus %8.1fus %8.1fus %8.1fus\n",
+           scenarios[i].name, planNames[frame.lastPlan.kind],
+           frame.lastPlan.commands, frame.lastPlan.data,
+           frame.lastPlan.cellsNs / 1000.0, frame.lastPlan.rowsNs / 1000.0,
+           frame.lastPlan.clearNs / 1000.0,
+           (hostGPIO.nowNs - start) / 1000.0);
+  }
+
+  printf("\n");
+}
+
+
+int main(int argc, char **argv) {
+  if (argc > 1)
+    hostGPIO.writeNs = strtoul(argv[1], NULL, 10);
+
+  {
+    NHD_OLED oled;
+    oled.begin(2, 3, 4, 20);
+    bench("SPI bit-bang", oled);
+  }
+
+  {
+    NHD_OLED oled;
+    oled.beginI2C(Wire, NHD_OLED_I2C_ADDRESS, 4, 20, 400000);
+    bench("I2C 400kHz", oled);
+  }
+
+  return 0;
+}
+
+
+
+/*
+ * End of file!
+ */
@@ -0,0 +1,164 @@
+/*
+ * Newhaven Display Slim OLED Driver - Display Service Thread Harness
+ * ------------------------------------------------------------------
+ *
+ * Runs NHD_OLED_Service the way multi-task firmware would: several
+ * std::thread producers post draw commands at full speed while the main
+ * thread, the only one touching the bus, drains the queue and flushes.
+ *
+ * Each producer owns one row and posts a counter to it over and over. Once
+ * every producer has finished, the decoded SPI traffic is replayed into a
+ * model of the display's DDRAM and each row is checked against the last
+ * value its producer managed to queue. The harness also reports how many
+ * commands were posted, how many were turned away by a full queue and
+ * retried, and how many data bytes reached the bus.
+ *
+ * Usage:
+ *   service_threads [posts per producer]
+ *
+ * Build with -pthread.
+ *
+ * Software License Agreement (BSD License) - see LICENSE.txt.
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include "HostGPIO.h"
+#include "NHD_OLED_Driver.h"
+#include "NHD_OLED_Frame.h"
+#include "NHD_OLED_Service.h"
+
+
+
+#define PIN_SCLK 2
+#define PIN_SDIN 3
+#define PRODUCERS 4
+
+NHD_OLED oled;
+NHD_OLED_Frame frame;
+NHD_OLED_Service service;
+
+static std::atomic<int> running(PRODUCERS);
+static unsigned long retries[PRODUCERS];
+static char last[PRODUCERS][21];
+
+
+
+// Posts "Task n: count" to row n, retrying whenever the queue is full.
+static void producer(int row, unsigned long posts) {
+  char text[21];
+  int len;
+
+  for (unsigned long i = 1; i <= posts; i++) {
+    len = snprintf(text, sizeof(text), "Task %d: %-12lu", row, i);
+
+    while (!service.print(text, len, row, 0)) {
+      retries[row]++;
+      std::this_thread::yield();
+    }
+  }
+
+  memcpy(last[row], text, 20);
+  last[row][20] = 0;
+  running--;
+}
+
+
+// Replays decoded frames into a model of the display's DDRAM, following
+// set-address and clear commands.
+static void replay(const std::vector<HostFrame> &frames, char ddram[128]) {
+  byte address = 0;
+
+  for (size_t i = 0; i < frames.size(); i++) {
+    if (frames[i].isCommand) {
+      if (frames[i].payload == 0x01) {
+        memset(ddram, ' ', 128);
+        address = 0;
+      }
+      else if (frames[i].payload & 0x80) {
+        address = frames[i].payload & 0x7F;
+      }
+    }
+    else {
+      ddram[address] = frames[i].payload;
+      address = (address + 1) & 0x7F;
+    }
+  }
+}
+
+
+int main(int argc, char **argv) {
+  unsigned long posts = (argc > 1) ? strtoul(argv[1], NULL, 10) : 10000;
+  std::vector<std::thread> threads;
+  std::vector<HostFrame> frames;
+  unsigned long passes = 0, data = 0, totalRetries = 0;
+  char ddram[128];
+  int failures = 0;
+
+  oled.begin(PIN_SCLK, PIN_SDIN, 4, 20);
+  frame.begin(oled);
+  service.begin(frame);
+
+  hostGPIO.clearLog();
+  memset(ddram, ' ', sizeof(ddram));
+
+  for (int i = 0; i < PRODUCERS; i++)
+    threads.push_back(std::thread(producer, i, posts));
+
+  // The owner: the only thread that ever touches the bus.
+  while (running > 0) {
+    service.service();
+    passes++;
+
+    // Keep the log small - decode and replay it as we go.
+    hostGPIO.decodeSPI(PIN_SCLK, PIN_SDIN, frames);
+    replay(frames, ddram);
+    for (size_t i = 0; i < frames.size(); i++)
+      if (!frames[i].isCommand)
+        data++;
+    hostGPIO.clearLog();
+  }
+
+  for (size_t i = 0; i < threads.size(); i++)
+    threads[i].join();
+
+  // Pick up whatever was posted after the last pass.
+  service.service();
+  hostGPIO.decodeSPI(PIN_SCLK, PIN_SDIN, frames);
+  replay(frames, ddram);
+  for (size_t i = 0; i < frames.size(); i++)
+    if (!frames[i].isCommand)
+      data++;
+
+  for (int i = 0; i < PRODUCERS; i++) {
+    totalRetries += retries[i];
+
+    if (memcmp(ddram + i * 0x20, last[i], 20) != 0) {
+      printf("Row %d: shows \"%.20s\", expected \"%s\"\n", i, ddram + i * 0x20,
+             last[i]);
+      failures++;
+    }
+  }
+
+  printf("%d producers x %lu posts, %lu owner passes\n", PRODUCERS, posts,
+         passes);
+  printf("Queue full: %lu times, %lu retries\n",
+         (unsigned long)service.dropped, totalRetries);
+  printf("Data bytes sent: %lu (%lu without coalescing)\n", data,
+         (unsigned long)PRODUCERS * posts * 20);
+  printf("%s\n", failures ? "FAILED" : "Final display matches every row");
+
+  return failures ? 1 : 0;
+}
+
+
+
+/*
+ * End of file!
+ */
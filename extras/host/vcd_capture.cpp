@@ -0,0 +1,135 @@
+/*
+ * Newhaven Display Slim OLED Driver - VCD Capture Tool
+ * ----------------------------------------------------
+ *
+ * Runs driver API calls against the simulated GPIO layer, writes the
+ * resulting SCLK/SDIN waveform to a VCD file for GTKWave and prints the
+ * decoded frames along with bus utilization and idle-gap statistics.
+ *
+ * Usage:
+ *   vcd_capture [scenario] [writeNs] [holdNs]
+ *
+ * With no scenario, every scenario is run and each one is written to
+ * <scenario>.vcd in the current directory. writeNs overrides the simulated
+ * cost of a digitalWrite() call (default 3500ns, roughly a 16MHz AVR) and
+ * holdNs the cost of one driver hold-loop iteration (default 375ns).
+ *
+ * Software License Agreement (BSD License) - see LICENSE.txt.
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "HostGPIO.h"
+#include "NHD_OLED_Driver.h"
+
+
+
+#define PIN_SCLK 2
+#define PIN_SDIN 3
+
+NHD_OLED oled;
+
+
+
+// Scenarios - each one is a short burst of API calls worth measuring.
+
+static void scenarioClear() {
+  oled.textClear();
+}
+
+static void scenarioPrint() {
+  oled.print((char *)"Hello World!", 12, 0, 0);
+}
+
+static void scenarioCentered() {
+  oled.textPrintCentered((char *)"Centered", 8, 1);
+}
+
+static void scenarioClearRow() {
+  oled.textClearRow(3);
+}
+
+static void scenarioSweep() {
+  oled.textSweep((char *)"Sweep!", 6, 2, '>', '<', 5);
+}
+
+struct Scenario {
+  const char *name;
+  void (*run)();
+};
+
+static const Scenario scenarios[] = {
+  {"clear",    scenarioClear},
+  {"print",    scenarioPrint},
+  {"centered", scenarioCentered},
+  {"clearrow", scenarioClearRow},
+  {"sweep",    scenarioSweep},
+};
+
+
+
+static void capture(const Scenario &scenario) {
+  std::vector<HostFrame> frames;
+  char path[64];
+
+  hostGPIO.clearLog();
+  scenario.run();
+
+  hostGPIO.decodeSPI(PIN_SCLK, PIN_SDIN, frames);
+
+  printf("=== %s ===\n", scenario.name);
+  hostGPIO.printFrames(stdout, frames);
+  hostGPIO.printSummary(stdout, frames);
+
+  snprintf(path, sizeof(path), "%s.vcd", scenario.name);
+  if (hostGPIO.writeVCD(path, PIN_SCLK, PIN_SDIN))
+    printf("Wrote %s\n\n", path);
+  else
+    printf("Could not write %s\n\n", path);
+}
+
+
+int main(int argc, char **argv) {
+  const char *only = (argc > 1) ? argv[1] : NULL;
+  size_t i;
+  bool found = false;
+
+  if (argc > 2)
+    hostGPIO.writeNs = strtoul(argv[2], NULL, 10);
+  if (argc > 3)
+    hostGPIO.holdNs = strtoul(argv[3], NULL, 10);
+
+  oled.begin(PIN_SCLK, PIN_SDIN, 4, 20);
+
+  printf("Calibration: pin write %uns, hold loop %uns, "
+         "SCLK hold %u/%u loops (high/low)\n\n",
+         oled.pinWriteNs, oled.holdLoopNs, oled.holdHighLoops,
+         oled.holdLowLoops);
+
+  for (i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+    if (only && strcmp(only, scenarios[i].name) != 0)
+      continue;
+    capture(scenarios[i]);
+    found = true;
+  }
+
+  if (!found) {
+    fprintf(stderr, "Unknown scenario \"%s\". Choose from:", only);
+    for (i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+      fprintf(stderr, " %s", scenarios[i].name);
+    fprintf(stderr, "\n");
+    return 1;
+  }
+
+  return 0;
+}
+
+
+
+/*
+ * End of file!
+ */